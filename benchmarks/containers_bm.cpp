@@ -0,0 +1,465 @@
+#include <unrolled_list.h>
+#include <unrolled_list_parallel.h>
+#include <unrolled_list_view.h>
+#include <unrolled_spsc_queue.h>
+#include <concurrent_unrolled_list.h>
+#include <external_unrolled_list.h>
+#include <persistent_unrolled_list.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+    Compares unrolled_list with std::list, std::deque and std::vector.
+    Each benchmark is parameterized by the container (and through it NodeMaxSize) and the
+    element type; the argument is the number of elements in the container.
+
+    JSON for comparing releases:
+        cmake --build <build> --target run-benchmarks
+    or
+        unrolled-list-benchmarks --benchmark_out=result.json --benchmark_out_format=json
+*/
+
+struct Pod64 {
+    std::int64_t values[8];
+};
+
+template<typename T>
+T MakeValue(const std::size_t i) {
+    if constexpr (std::is_same_v<T, std::string>) {
+        // longer than the small string buffer, so every element owns a heap block
+        return std::string(24, static_cast<char>('a' + i % 26));
+    } else if constexpr (std::is_same_v<T, Pod64>) {
+        return Pod64{{static_cast<std::int64_t>(i)}};
+    } else {
+        return static_cast<T>(i);
+    }
+}
+
+template<typename T>
+std::int64_t Touch(const T& value) {
+    if constexpr (std::is_same_v<T, std::string>) {
+        return value[0];
+    } else if constexpr (std::is_same_v<T, Pod64>) {
+        return value.values[0];
+    } else {
+        return value;
+    }
+}
+
+template<typename Container>
+Container MakeContainer(const std::size_t size) {
+    Container container;
+    for (std::size_t i = 0; i < size; ++i) {
+        container.push_back(MakeValue<typename Container::value_type>(i));
+    }
+    return container;
+}
+
+template<typename Container>
+auto IteratorAt(Container& container, const std::size_t position) {
+    return std::next(container.begin(), position);
+}
+
+template<typename T, std::size_t NodeMaxSize, typename Allocator, typename... Policies>
+auto IteratorAt(unrolled_list<T, NodeMaxSize, Allocator, Policies...>& container, const std::size_t position) {
+    return container.begin() + position;
+}
+
+template<typename Container>
+void BM_PushBack(benchmark::State& state) {
+    using T = typename Container::value_type;
+    const std::size_t size = state.range(0);
+    for (auto _ : state) {
+        Container container;
+        for (std::size_t i = 0; i < size; ++i) {
+            container.push_back(MakeValue<T>(i));
+        }
+        benchmark::DoNotOptimize(container);
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+template<typename Container>
+void BM_PushFront(benchmark::State& state) {
+    using T = typename Container::value_type;
+    const std::size_t size = state.range(0);
+    for (auto _ : state) {
+        Container container;
+        for (std::size_t i = 0; i < size; ++i) {
+            container.push_front(MakeValue<T>(i));
+        }
+        benchmark::DoNotOptimize(container);
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+template<typename Container>
+void BM_PopBack(benchmark::State& state) {
+    const std::size_t size = state.range(0);
+    for (auto _ : state) {
+        state.PauseTiming();
+        Container container = MakeContainer<Container>(size);
+        state.ResumeTiming();
+        while (!container.empty()) {
+            container.pop_back();
+        }
+        benchmark::DoNotOptimize(container);
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+template<typename Container>
+void BM_PopFront(benchmark::State& state) {
+    const std::size_t size = state.range(0);
+    for (auto _ : state) {
+        state.PauseTiming();
+        Container container = MakeContainer<Container>(size);
+        state.ResumeTiming();
+        while (!container.empty()) {
+            container.pop_front();
+        }
+        benchmark::DoNotOptimize(container);
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+template<typename Container>
+void BM_MiddleInsertErase(benchmark::State& state) {
+    using T = typename Container::value_type;
+    const std::size_t size = state.range(0);
+    Container container = MakeContainer<Container>(size);
+    auto it = IteratorAt(container, size / 2);
+    std::size_t i = 0;
+    for (auto _ : state) {
+        it = container.insert(it, MakeValue<T>(i++));
+        it = container.erase(it);
+        benchmark::DoNotOptimize(*it);
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+
+template<typename Container>
+void BM_Iterate(benchmark::State& state) {
+    const std::size_t size = state.range(0);
+    Container container = MakeContainer<Container>(size);
+    for (auto _ : state) {
+        std::int64_t sum = 0;
+        for (const auto& value : container) {
+            sum += Touch(value);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+// ul_for_each runs node by node for unrolled_list and is std::for_each for the rest
+template<typename Container>
+void BM_SegmentedIterate(benchmark::State& state) {
+    const std::size_t size = state.range(0);
+    Container container = MakeContainer<Container>(size);
+    for (auto _ : state) {
+        std::int64_t sum = 0;
+        ul_for_each(container.begin(), container.end(), [&sum](const auto& value) { sum += Touch(value); });
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+template<typename Container>
+void BM_ReverseIterate(benchmark::State& state) {
+    const std::size_t size = state.range(0);
+    Container container = MakeContainer<Container>(size);
+    for (auto _ : state) {
+        std::int64_t sum = 0;
+        for (auto it = container.rbegin(); it != container.rend(); ++it) {
+            sum += Touch(*it);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+template<typename Container>
+void BM_PositionalAdvance(benchmark::State& state) {
+    const std::size_t size = state.range(0);
+    Container container = MakeContainer<Container>(size);
+    std::mt19937 gen(42);
+    std::vector<std::size_t> positions(1024);
+    for (auto& position : positions) {
+        position = gen() % size;
+    }
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Touch(*IteratorAt(container, positions[i++ % positions.size()])));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<typename Container>
+void BM_CopyConstruct(benchmark::State& state) {
+    const std::size_t size = state.range(0);
+    const Container container = MakeContainer<Container>(size);
+    for (auto _ : state) {
+        Container copy(container);
+        benchmark::DoNotOptimize(copy);
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+// assignment into a list of the same size, so node storage can be reused
+template<typename Container>
+void BM_CopyAssign(benchmark::State& state) {
+    const std::size_t size = state.range(0);
+    const Container container = MakeContainer<Container>(size);
+    Container copy = MakeContainer<Container>(size);
+    for (auto _ : state) {
+        copy = container;
+        benchmark::DoNotOptimize(copy);
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+// a checkpoint copy followed by one write: unrolled_list copies every element,
+// persistent_unrolled_list shares the nodes and clones the spine path and node it writes to
+template<typename Container>
+void BM_CheckpointAndWrite(benchmark::State& state) {
+    const std::size_t size = state.range(0);
+    Container container = MakeContainer<Container>(size);
+    for (auto _ : state) {
+        Container checkpoint(container);
+        container.push_front(MakeValue<typename Container::value_type>(0));
+        container.pop_front();
+        benchmark::DoNotOptimize(checkpoint);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<typename Container>
+void BM_Clear(benchmark::State& state) {
+    const std::size_t size = state.range(0);
+    for (auto _ : state) {
+        state.PauseTiming();
+        Container container = MakeContainer<Container>(size);
+        state.ResumeTiming();
+        container.clear();
+        benchmark::DoNotOptimize(container);
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+// ul_reduce(ul_par, ...) on the shared pool; vector runs through the same chunking
+template<typename Container>
+void BM_ParallelReduce(benchmark::State& state) {
+    const std::size_t size = state.range(0);
+    Container container = MakeContainer<Container>(size);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ul_reduce(ul_par, container.begin(), container.end(), std::int64_t{0}));
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+// Hand-off of state.range(0) ints from a producer thread to the benchmark thread.
+template<typename Queue>
+void BM_HandOff(benchmark::State& state) {
+    const int count = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        Queue queue;
+        std::thread producer([&queue, count] {
+            for (int i = 0; i < count; ++i) {
+                queue.push(i);
+            }
+        });
+        std::int64_t sum = 0;
+        for (int received = 0; received < count;) {
+            int value;
+            if (queue.try_pop(value)) {
+                sum += value;
+                ++received;
+            }
+        }
+        producer.join();
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+// The same hand-off through a mutex-guarded unrolled_list.
+class LockedListQueue {
+public:
+    void push(int value) {
+        std::lock_guard lock(mutex_);
+        list_.push_back(value);
+    }
+
+    bool try_pop(int& value) {
+        std::lock_guard lock(mutex_);
+        if (list_.empty()) {
+            return false;
+        }
+        value = list_.front();
+        list_.pop_front();
+        return true;
+    }
+
+private:
+    std::mutex mutex_;
+    unrolled_list<int, 64> list_;
+};
+
+// Every benchmark thread inserts and erases in its own region of one shared list.
+void BM_ConcurrentRegions(benchmark::State& state) {
+    static concurrent_unrolled_list<int, 64>* list = nullptr;
+    constexpr std::size_t region = 4096;
+    if (state.thread_index() == 0) {
+        list = new concurrent_unrolled_list<int, 64>;
+        for (std::size_t i = 0; i < region * state.threads(); ++i) {
+            list->push_back(static_cast<int>(i));
+        }
+    }
+    const std::size_t position = region * state.thread_index() + region / 2;
+    for (auto _ : state) {
+        list->insert(position, 1);
+        list->erase(position);
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+    if (state.thread_index() == 0) {
+        delete list;
+    }
+}
+
+// Cold start from a file of state.range(0) ints: push_back of every element read from a
+// stream, load() of whole node blocks, and an unrolled_list_view over the mapped file.
+std::filesystem::path SavedInts(const std::size_t size) {
+    const auto path = std::filesystem::temp_directory_path() / "unrolled_list_bm.bin";
+    MakeContainer<unrolled_list<int, 128>>(size).save(path);
+    return path;
+}
+
+void BM_LoadByPushBack(benchmark::State& state) {
+    const std::size_t size = state.range(0);
+    const auto path = SavedInts(size);
+    for (auto _ : state) {
+        const unrolled_list_view<int> view(path);
+        unrolled_list<int, 128> list;
+        for (int value : view) {
+            list.push_back(value);
+        }
+        benchmark::DoNotOptimize(list);
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+void BM_Load(benchmark::State& state) {
+    const std::size_t size = state.range(0);
+    const auto path = SavedInts(size);
+    for (auto _ : state) {
+        unrolled_list<int, 128> list;
+        list.load(path);
+        benchmark::DoNotOptimize(list);
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+void BM_MapView(benchmark::State& state) {
+    const std::size_t size = state.range(0);
+    const auto path = SavedInts(size);
+    for (auto _ : state) {
+        const unrolled_list_view<int> view(path);
+        benchmark::DoNotOptimize(view.size());
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+// Sequential scan of state.range(0) ints paged through 16 resident 64 KiB nodes,
+// with state.range(1) blocks of readahead.
+void BM_ExternalScan(benchmark::State& state) {
+    const std::size_t size = state.range(0);
+    const auto path = std::filesystem::temp_directory_path() / "unrolled_list_bm_external";
+    external_unrolled_list<int> list(path, 16, state.range(1));
+    for (std::size_t i = 0; i < size; ++i) {
+        list.push_back(static_cast<int>(i));
+    }
+    for (auto _ : state) {
+        std::int64_t sum = 0;
+        for (int value : list) {
+            sum += value;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+    state.SetBytesProcessed(state.iterations() * size * sizeof(int));
+}
+
+// The same scan through ul_accumulate, a tight loop over each pinned node.
+void BM_ExternalSegmentedScan(benchmark::State& state) {
+    const std::size_t size = state.range(0);
+    const auto path = std::filesystem::temp_directory_path() / "unrolled_list_bm_external";
+    external_unrolled_list<int> list(path, 16, state.range(1));
+    for (std::size_t i = 0; i < size; ++i) {
+        list.push_back(static_cast<int>(i));
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ul_accumulate(list.cbegin(), list.cend(), std::int64_t{0}));
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+    state.SetBytesProcessed(state.iterations() * size * sizeof(int));
+}
+
+#define UL_SIZES ->RangeMultiplier(16)->Range(1 << 8, 1 << 16)
+
+#define UL_ANY_CONTAINER(BM, T)                             \
+    BENCHMARK_TEMPLATE(BM, std::vector<T>) UL_SIZES;        \
+    UL_LIST_LIKE(BM, T)
+
+#define UL_LIST_LIKE(BM, T)                                 \
+    BENCHMARK_TEMPLATE(BM, std::deque<T>) UL_SIZES;         \
+    BENCHMARK_TEMPLATE(BM, std::list<T>) UL_SIZES;          \
+    BENCHMARK_TEMPLATE(BM, unrolled_list<T, 8>) UL_SIZES;   \
+    BENCHMARK_TEMPLATE(BM, unrolled_list<T, 32>) UL_SIZES;  \
+    BENCHMARK_TEMPLATE(BM, unrolled_list<T, 128>) UL_SIZES
+
+#define UL_ALL_BENCHMARKS(T)                    \
+    UL_ANY_CONTAINER(BM_PushBack, T);           \
+    UL_LIST_LIKE(BM_PushFront, T);              \
+    UL_ANY_CONTAINER(BM_PopBack, T);            \
+    UL_LIST_LIKE(BM_PopFront, T);               \
+    UL_ANY_CONTAINER(BM_MiddleInsertErase, T);  \
+    UL_ANY_CONTAINER(BM_Iterate, T);            \
+    UL_ANY_CONTAINER(BM_SegmentedIterate, T);   \
+    UL_ANY_CONTAINER(BM_ReverseIterate, T);     \
+    UL_ANY_CONTAINER(BM_PositionalAdvance, T);  \
+    UL_ANY_CONTAINER(BM_CopyConstruct, T);      \
+    UL_ANY_CONTAINER(BM_CopyAssign, T);         \
+    UL_ANY_CONTAINER(BM_Clear, T)
+
+UL_ALL_BENCHMARKS(int);
+UL_ALL_BENCHMARKS(Pod64);
+UL_ALL_BENCHMARKS(std::string);
+
+BENCHMARK_TEMPLATE(BM_ParallelReduce, std::vector<int>)->RangeMultiplier(16)->Range(1 << 16, 1 << 24);
+BENCHMARK_TEMPLATE(BM_ParallelReduce, unrolled_list<int, 128>)->RangeMultiplier(16)->Range(1 << 16, 1 << 24);
+
+BENCHMARK_TEMPLATE(BM_CheckpointAndWrite, unrolled_list<int, 64>) UL_SIZES;
+BENCHMARK_TEMPLATE(BM_CheckpointAndWrite, persistent_unrolled_list<int, 64>) UL_SIZES;
+
+BENCHMARK_TEMPLATE(BM_HandOff, unrolled_spsc_queue<int, 64>)->Arg(1 << 20)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_HandOff, LockedListQueue)->Arg(1 << 20)->UseRealTime();
+BENCHMARK(BM_ConcurrentRegions)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK(BM_LoadByPushBack)->Arg(1 << 22);
+BENCHMARK(BM_Load)->Arg(1 << 22);
+BENCHMARK(BM_MapView)->Arg(1 << 22);
+
+BENCHMARK(BM_ExternalScan)->Args({1 << 22, 0})->Args({1 << 22, 8});
+BENCHMARK(BM_ExternalSegmentedScan)->Args({1 << 22, 0})->Args({1 << 22, 8});
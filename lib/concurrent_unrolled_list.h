@@ -0,0 +1,478 @@
+#pragma once
+#include "unrolled_list.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+// Test-and-test-and-set lock, one per node of concurrent_unrolled_list.
+class ul_spin_lock {
+public:
+
+    void lock() noexcept {
+        while (locked_.exchange(true, std::memory_order_acquire)) {
+            while (locked_.load(std::memory_order_relaxed)) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    bool try_lock() noexcept {
+        return !locked_.load(std::memory_order_relaxed) && !locked_.exchange(true, std::memory_order_acquire);
+    }
+
+    void unlock() noexcept {
+        locked_.store(false, std::memory_order_release);
+    }
+
+private:
+    std::atomic<bool> locked_ = false;
+};
+
+/*
+    Unrolled list for several writers at once. Every node carries its own lock.
+
+    Positional operations walk from the head with lock coupling: the lock of the next
+    node is taken before the lock of the previous one is released, so a walker always
+    holds the predecessor of the node it looks at. A split links the new node while
+    holding only the node being split; removing an emptied node holds only it and its
+    predecessor. Writers working on different parts of the list therefore only meet
+    while passing through the nodes in front of them.
+
+    push_back skips the walk: it locks the node published in the atomic tail_ and
+    retries if that node stopped being the tail. Such a pusher can hold a pointer to a
+    node that is being removed, so it announces the node in a hazard slot first. Removed
+    nodes are retired, and once enough have piled up the ones no slot announces are
+    freed; at most reclaim_threshold + hazard_slots removed nodes stay allocated.
+
+    Positions are only meaningful with respect to the moment the operation runs: each
+    member is atomic on its own, sequences of calls are not. size() is exact when no
+    writer is running. T must be nothrow move constructible, as elements are shifted
+    while locks are held.
+*/
+template<typename T, size_t NodeMaxSize = 16, typename Allocator = std::allocator<T>>
+class concurrent_unrolled_list {
+    static_assert(NodeMaxSize > 1, "concurrent_unrolled_list splits nodes, so they need room for two elements");
+    static_assert(std::is_nothrow_move_constructible_v<T>, "elements are shifted while node locks are held");
+
+    struct NodeBase {
+        ul_spin_lock lock;
+        size_t node_size = 0;
+        bool removed = false;
+        NodeBase* next = nullptr;
+    };
+
+    struct Node : NodeBase {
+        alignas(T) unsigned char storage[sizeof(T) * NodeMaxSize];
+
+        T* data() noexcept {
+            return std::launder(reinterpret_cast<T*>(storage));
+        }
+    };
+
+    using t_allocator_traits = std::allocator_traits<Allocator>;
+    using node_allocator = typename t_allocator_traits::template rebind_alloc<Node>;
+    using node_allocator_traits = std::allocator_traits<node_allocator>;
+
+public:
+    using value_type = T;
+    using allocator_type = Allocator;
+
+    explicit concurrent_unrolled_list(const allocator_type& alloc = allocator_type())
+    : t_alloc_(alloc), node_alloc_(alloc) {
+    }
+
+    concurrent_unrolled_list(const concurrent_unrolled_list&) = delete;
+    concurrent_unrolled_list& operator=(const concurrent_unrolled_list&) = delete;
+
+    ~concurrent_unrolled_list() {
+        NodeBase* node = head_.next;
+        while (node) {
+            NodeBase* next = node->next;
+            delete_node(as_node(node));
+            node = next;
+        }
+        free_retired();
+    }
+
+    size_t size() const noexcept {
+        return size_.load(std::memory_order_relaxed);
+    }
+
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    void push_back(const T& value) {
+        emplace_back(value);
+    }
+
+    void push_back(T&& value) {
+        emplace_back(std::move(value));
+    }
+
+    template<typename... Args>
+    void emplace_back(Args&&... args) {
+        T value(std::forward<Args>(args)...);
+        NodeBase* tail = tail_.load(std::memory_order_seq_cst);
+        std::atomic<NodeBase*>& hazard = acquire_hazard(tail);
+        while (true) {
+            tail = protect_tail(hazard, tail);
+            tail->lock.lock();
+            // removed is checked first: the next of a removed node links the retired nodes
+            if (tail->removed || tail->next != nullptr) {
+                tail->lock.unlock();
+                tail = tail_.load(std::memory_order_seq_cst);
+                continue;
+            }
+            try {
+                append_locked(tail, std::move(value));
+            } catch (...) {
+                tail->lock.unlock();
+                hazard.store(nullptr, std::memory_order_release);
+                throw;
+            }
+            tail->lock.unlock();
+            break;
+        }
+        hazard.store(nullptr, std::memory_order_release);
+        size_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void push_front(const T& value) {
+        insert(0, value);
+    }
+
+    void push_front(T&& value) {
+        insert(0, std::move(value));
+    }
+
+    // Inserts value before position index; returns false if index exceeds the size.
+    bool insert(const size_t index, const T& value) {
+        return emplace(index, value);
+    }
+
+    bool insert(const size_t index, T&& value) {
+        return emplace(index, std::move(value));
+    }
+
+    template<typename... Args>
+    bool emplace(size_t index, Args&&... args) {
+        T value(std::forward<Args>(args)...);
+        auto [prev, node] = lock_for_insert(index);
+        try {
+            if (node == nullptr) {
+                if (index != 0) {
+                    prev->lock.unlock();
+                    return false;
+                }
+                append_locked(prev, std::move(value));
+            } else {
+                insert_locked(as_node(node), index, std::move(value));
+                node->lock.unlock();
+            }
+        } catch (...) {
+            if (node) {
+                node->lock.unlock();
+            }
+            prev->lock.unlock();
+            throw;
+        }
+        prev->lock.unlock();
+        size_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Erases the element at index; returns false if there is none.
+    bool erase(size_t index) {
+        auto [prev, node] = lock_for_access(index);
+        if (node == nullptr) {
+            prev->lock.unlock();
+            return false;
+        }
+        T* data = as_node(node)->data();
+        std::move(data + index + 1, data + node->node_size, data + index);
+        t_allocator_traits::destroy(t_alloc_, data + node->node_size - 1);
+        --node->node_size;
+        size_.fetch_sub(1, std::memory_order_relaxed);
+        if (node->node_size != 0) {
+            node->lock.unlock();
+            prev->lock.unlock();
+            return true;
+        }
+
+        prev->next = node->next;
+        if (node->next == nullptr) {
+            tail_.store(prev, std::memory_order_seq_cst);
+        }
+        node->removed = true;
+        node->lock.unlock();
+        prev->lock.unlock();
+        retire(as_node(node));
+        return true;
+    }
+
+    // Copies the element at index into value; returns false if there is none.
+    bool read(size_t index, T& value) const {
+        return const_cast<concurrent_unrolled_list*>(this)->update(index, [&value](const T& element) {
+            value = element;
+        });
+    }
+
+    // Calls function(T&) on the element at index while its node is locked.
+    template<typename Function>
+    bool update(size_t index, Function function) {
+        auto [prev, node] = lock_for_access(index);
+        prev->lock.unlock();
+        if (node == nullptr) {
+            return false;
+        }
+        try {
+            function(as_node(node)->data()[index]);
+        } catch (...) {
+            node->lock.unlock();
+            throw;
+        }
+        node->lock.unlock();
+        return true;
+    }
+
+    // Calls function(const T&) on every element, front to back, one node lock at a time.
+    template<typename Function>
+    void for_each(Function function) const {
+        NodeBase* node = const_cast<NodeBase*>(&head_);
+        node->lock.lock();
+        while (node->next) {
+            NodeBase* next = node->next;
+            next->lock.lock();
+            node->lock.unlock();
+            node = next;
+            const T* data = as_node(node)->data();
+            try {
+                for (size_t i = 0; i < node->node_size; ++i) {
+                    function(data[i]);
+                }
+            } catch (...) {
+                node->lock.unlock();
+                throw;
+            }
+        }
+        node->lock.unlock();
+    }
+
+private:
+
+    static Node* as_node(NodeBase* node) noexcept {
+        return static_cast<Node*>(node);
+    }
+
+    struct locked_pair {
+        NodeBase* prev;
+        NodeBase* node;
+    };
+
+    // Lock coupling from the head until accept(node, index) holds. Returns the node and its
+    // predecessor, both locked, with index made local to the node; or the last node as prev
+    // (locked) and nullptr if the walk ran off the end.
+    template<typename Accept>
+    locked_pair lock_coupled(size_t& index, Accept accept) {
+        NodeBase* prev = &head_;
+        prev->lock.lock();
+        NodeBase* node = prev->next;
+        while (node) {
+            node->lock.lock();
+            if (accept(node, index)) {
+                return {prev, node};
+            }
+            index -= node->node_size;
+            prev->lock.unlock();
+            prev = node;
+            node = node->next;
+        }
+        return {prev, nullptr};
+    }
+
+    locked_pair lock_for_access(size_t& index) {
+        return lock_coupled(index, [](NodeBase* node, size_t local) {
+            return local < node->node_size;
+        });
+    }
+
+    // A position at the end of a node goes into that node if it has room.
+    locked_pair lock_for_insert(size_t& index) {
+        return lock_coupled(index, [](NodeBase* node, size_t local) {
+            return local < node->node_size || (local == node->node_size && node->node_size < NodeMaxSize);
+        });
+    }
+
+    // Appends to tail, which is locked and has no successor.
+    void append_locked(NodeBase* tail, T&& value) {
+        if (tail == &head_ || tail->node_size == NodeMaxSize) {
+            Node* node = new_node();
+            t_allocator_traits::construct(t_alloc_, node->data(), std::move(value));
+            node->node_size = 1;
+            tail->next = node;
+            tail_.store(node, std::memory_order_seq_cst);
+            return;
+        }
+        t_allocator_traits::construct(t_alloc_, as_node(tail)->data() + tail->node_size, std::move(value));
+        ++tail->node_size;
+    }
+
+    // node is locked. A full node is split in half first; the new node is filled before
+    // it is linked or published as the tail, so nobody else can reach it and it needs no lock.
+    void insert_locked(Node* node, size_t index, T&& value) {
+        if (node->node_size == NodeMaxSize) {
+            Node* split = new_node();
+            const size_t keep = NodeMaxSize / 2;
+            T* data = node->data();
+            for (size_t i = keep; i < NodeMaxSize; ++i) {
+                t_allocator_traits::construct(t_alloc_, split->data() + (i - keep), std::move(data[i]));
+                t_allocator_traits::destroy(t_alloc_, data + i);
+            }
+            split->node_size = NodeMaxSize - keep;
+            node->node_size = keep;
+            if (index > keep) {
+                insert_in_node(split, index - keep, std::move(value));
+            } else {
+                insert_in_node(node, index, std::move(value));
+            }
+            split->next = node->next;
+            node->next = split;
+            if (split->next == nullptr) {
+                tail_.store(split, std::memory_order_seq_cst);
+            }
+            return;
+        }
+        insert_in_node(node, index, std::move(value));
+    }
+
+    void insert_in_node(Node* node, const size_t index, T&& value) noexcept {
+        T* data = node->data();
+        const size_t node_size = node->node_size;
+        if (index == node_size) {
+            t_allocator_traits::construct(t_alloc_, data + node_size, std::move(value));
+        } else {
+            t_allocator_traits::construct(t_alloc_, data + node_size, std::move(data[node_size - 1]));
+            std::move_backward(data + index, data + node_size - 1, data + node_size);
+            data[index] = std::move(value);
+        }
+        ++node->node_size;
+    }
+
+    Node* new_node() {
+        Node* node = node_allocator_traits::allocate(node_alloc_, 1);
+        node_allocator_traits::construct(node_alloc_, node);
+        return node;
+    }
+
+    void delete_node(Node* node) noexcept {
+        for (size_t i = 0; i < node->node_size; ++i) {
+            t_allocator_traits::destroy(t_alloc_, node->data() + i);
+        }
+        node_allocator_traits::destroy(node_alloc_, node);
+        node_allocator_traits::deallocate(node_alloc_, node, 1);
+    }
+
+    // Each thread starts looking for a free hazard slot at its own one, so pushers on
+    // different threads do not share a cache line.
+    static size_t hazard_hint() noexcept {
+        static std::atomic<size_t> next_hint = 0;
+        thread_local const size_t hint = next_hint.fetch_add(1, std::memory_order_relaxed);
+        return hint;
+    }
+
+    // Claims a free hazard slot by storing node into it; spins while all are taken.
+    std::atomic<NodeBase*>& acquire_hazard(NodeBase* node) noexcept {
+        for (size_t i = hazard_hint(); ; ++i) {
+            std::atomic<NodeBase*>& slot = hazards_[i % hazard_slots].node;
+            NodeBase* expected = nullptr;
+            if (slot.load(std::memory_order_relaxed) == nullptr
+                && slot.compare_exchange_strong(expected, node, std::memory_order_seq_cst)) {
+                return slot;
+            }
+            if ((i + 1) % hazard_slots == hazard_hint() % hazard_slots) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    // Announces tail in hazard until tail_ still points at it afterwards: from then on
+    // a retire of that node finds it announced and does not free it.
+    NodeBase* protect_tail(std::atomic<NodeBase*>& hazard, NodeBase* tail) noexcept {
+        while (true) {
+            hazard.store(tail, std::memory_order_seq_cst);
+            NodeBase* current = tail_.load(std::memory_order_seq_cst);
+            if (current == tail) {
+                return tail;
+            }
+            tail = current;
+        }
+    }
+
+    // node is unlinked and tail_ no longer points at it, so only a push_back that
+    // announced it earlier can still reach it. Links node into retired_ through its
+    // next and allocates nothing, so it cannot fail after the unlink.
+    void retire(Node* node) noexcept {
+        retired_lock_.lock();
+        node->next = retired_;
+        retired_ = node;
+        if (++retired_count_ >= reclaim_threshold) {
+            reclaim_locked();
+        }
+        retired_lock_.unlock();
+    }
+
+    // Frees the retired nodes no hazard slot announces; retired_lock_ is held.
+    void reclaim_locked() noexcept {
+        std::array<NodeBase*, hazard_slots> announced;
+        for (size_t i = 0; i < hazard_slots; ++i) {
+            announced[i] = hazards_[i].node.load(std::memory_order_seq_cst);
+        }
+        std::sort(announced.begin(), announced.end());
+
+        NodeBase** link = &retired_;
+        while (*link) {
+            NodeBase* node = *link;
+            if (std::binary_search(announced.begin(), announced.end(), node)) {
+                link = &node->next;
+                continue;
+            }
+            *link = node->next;
+            delete_node(as_node(node));
+            --retired_count_;
+        }
+    }
+
+    void free_retired() noexcept {
+        while (retired_) {
+            NodeBase* next = retired_->next;
+            delete_node(as_node(retired_));
+            retired_ = next;
+        }
+        retired_count_ = 0;
+    }
+
+    static constexpr size_t hazard_slots = 64;
+    static constexpr size_t reclaim_threshold = 2 * hazard_slots;
+
+    struct alignas(ul_cache_line_size) hazard_slot {
+        std::atomic<NodeBase*> node = nullptr;
+    };
+
+    [[no_unique_address]] allocator_type t_alloc_;
+    [[no_unique_address]] node_allocator node_alloc_;
+    NodeBase head_;
+    alignas(ul_cache_line_size) std::atomic<NodeBase*> tail_ = &head_;
+    alignas(ul_cache_line_size) std::atomic<size_t> size_ = 0;
+    std::array<hazard_slot, hazard_slots> hazards_;
+    ul_spin_lock retired_lock_;
+    NodeBase* retired_ = nullptr;
+    size_t retired_count_ = 0;
+};
@@ -0,0 +1,828 @@
+#pragma once
+#include "unrolled_list.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <iterator>
+#include <mutex>
+#include <new>
+#include <ranges>
+#include <span>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+/*
+    Unrolled list whose node blocks live in a scratch file. Only the links and sizes of
+    the nodes stay in memory; their elements are paged through a pool of resident
+    frames, by default resident_limit of them, and the least recently used unpinned
+    frame is evicted (written back if dirty) when another node is needed.
+
+    An iterator pins the frame of its node, so references it hands out stay valid while
+    it exists; the pool only grows past resident_limit when every frame is pinned.
+    Stepping an iterator or segment iterator into the next node starts asynchronous
+    reads of the following prefetch_nodes blocks: a reader thread, started on the first
+    scan, loads them into frames it may take without growing the pool, and an access to
+    a node still being read waits for it. A sequential scan thus overlaps disk reads with
+    the work on the current node. Element access by index and front()/back() return
+    copies, because a reference without a pin could be evicted by the next access.
+
+    This is a container of its own rather than a storage policy of unrolled_list:
+    unrolled_list hands out references and spans into node storage for as long as the
+    node exists, which paged blocks cannot promise without a pin. What the two share is
+    the segmented iterator protocol, so ul_for_each, ul_find, ul_count, ul_accumulate,
+    ul_copy, ul_fill and ul_transform run over external lists node by node, each node
+    pinned while it is visited; over iterator (not const_iterator) they mark every
+    visited block dirty. The ul_par overloads do not accept paged iterators, since the
+    frame pool is not shared between threads.
+
+    T must be trivially copyable: blocks go to and come from the file as raw bytes.
+    insert and erase invalidate iterators, which may still be destroyed or assigned.
+    The file is unlinked as soon as it is created, so nothing outlives the list. POSIX only.
+*/
+template<typename T, size_t NodeMaxSize = (size_t{1} << 16) / sizeof(T)>
+class external_unrolled_list {
+    static_assert(std::is_trivially_copyable_v<T>, "external_unrolled_list pages elements as raw bytes");
+    static_assert(NodeMaxSize > 1, "external_unrolled_list splits nodes, so they need room for two elements");
+
+    static constexpr size_t block_bytes = NodeMaxSize * sizeof(T);
+
+    struct Frame;
+
+    struct NodeBase {
+        size_t node_size = 0;
+        NodeBase* next = this;
+        NodeBase* prev = this;
+    };
+
+    // In memory part of a node: where its block is in the file and, if resident, its frame.
+    struct Node : NodeBase {
+        std::uint64_t block = 0;
+        Frame* frame = nullptr;
+    };
+
+    // Link part of a frame. The pool owns one FrameLink as the sentinel of its LRU order:
+    // next is the most recently used frame, prev the least.
+    struct FrameLink {
+        FrameLink* next = this;
+        FrameLink* prev = this;
+    };
+
+    struct Frame : FrameLink {
+        Node* owner = nullptr;
+        size_t pins = 0;
+        bool dirty = false;
+        // Set while the reader thread fills storage; such a frame is neither taken nor read.
+        std::atomic<bool> loading = false;
+        // What the reader thread loads, and the errno it failed with.
+        std::uint64_t load_block = 0;
+        size_t load_bytes = 0;
+        int load_error = 0;
+        alignas(T) std::byte storage[block_bytes];
+
+        // User-provided, so that value-initialization does not zero the storage.
+        Frame() noexcept {}
+
+        T* data() noexcept {
+            return std::launder(reinterpret_cast<T*>(storage));
+        }
+    };
+
+    // Keeps a frame resident for the duration of an operation.
+    struct pin_guard {
+        Frame* frame;
+
+        ~pin_guard() {
+            --frame->pins;
+        }
+    };
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+
+    template<bool IsConst>
+    struct ul_paged_segment_iterator;
+
+    template<bool IsConst>
+    class ul_paged_iterator {
+    public:
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<IsConst, const T&, T&>;
+        using pointer = std::conditional_t<IsConst, const T*, T*>;
+        using iterator_category = std::bidirectional_iterator_tag;
+
+        ul_paged_iterator() = default;
+
+        ul_paged_iterator(const ul_paged_iterator& other) noexcept
+        : list_(other.list_), node_(other.node_), index_(other.index_), frame_(other.frame_) {
+            if (frame_) {
+                ++frame_->pins;
+            }
+        }
+
+        template<bool OtherConst, typename = std::enable_if_t<IsConst && !OtherConst>>
+        ul_paged_iterator(const ul_paged_iterator<OtherConst>& other) noexcept
+        : list_(other.list_), node_(other.node_), index_(other.index_), frame_(other.frame_) {
+            if (frame_) {
+                ++frame_->pins;
+            }
+        }
+
+        ul_paged_iterator(ul_paged_iterator&& other) noexcept
+        : list_(other.list_), node_(other.node_), index_(other.index_), frame_(std::exchange(other.frame_, nullptr)) {
+        }
+
+        ul_paged_iterator& operator=(ul_paged_iterator other) noexcept {
+            std::swap(list_, other.list_);
+            std::swap(node_, other.node_);
+            std::swap(index_, other.index_);
+            std::swap(frame_, other.frame_);
+            return *this;
+        }
+
+        ~ul_paged_iterator() {
+            if (frame_) {
+                --frame_->pins;
+            }
+        }
+
+        // A mutable dereference marks the block dirty.
+        reference operator*() const {
+            if constexpr (!IsConst) {
+                frame_->dirty = true;
+            }
+            return frame_->data()[index_];
+        }
+
+        pointer operator->() const {
+            return &**this;
+        }
+
+        ul_paged_iterator& operator++() {
+            if (index_ + 1 < node_->node_size) {
+                ++index_;
+                return *this;
+            }
+            step_node();
+            return *this;
+        }
+
+        ul_paged_iterator operator++(int) {
+            ul_paged_iterator temp = *this;
+            ++(*this);
+            return temp;
+        }
+
+        ul_paged_iterator& operator--() {
+            if (index_ > 0) {
+                --index_;
+                return *this;
+            }
+            move_to(node_->prev, node_->prev->node_size - 1);
+            return *this;
+        }
+
+        ul_paged_iterator operator--(int) {
+            ul_paged_iterator temp = *this;
+            --(*this);
+            return temp;
+        }
+
+        bool operator==(const ul_paged_iterator& other) const noexcept {
+            return node_ == other.node_ && index_ == other.index_;
+        }
+
+        // Segmented iterator protocol of the ul_* algorithms; every node is pinned while
+        // visit runs over it, and blocks reached through a mutable iterator become dirty.
+        static constexpr bool is_segmented = true;
+        static constexpr bool is_paged = true;
+
+        template<typename Visitor>
+        static ul_paged_iterator visit_segments(const ul_paged_iterator& first, const ul_paged_iterator& last,
+                                                Visitor&& visit) {
+            if (first == last) {
+                return last;
+            }
+            ul_paged_iterator it = first;
+            while (true) {
+                const size_t to = it.node_ == last.node_ ? last.index_ : it.node_->node_size;
+                if constexpr (!IsConst) {
+                    it.frame_->dirty = true;
+                }
+                pointer data = it.frame_->data();
+                pointer stop = visit(data + it.index_, data + to);
+                if (stop != data + to) {
+                    it.index_ = static_cast<size_t>(stop - data);
+                    return it;
+                }
+                if (it.node_ == last.node_) {
+                    return last;
+                }
+                it.step_node();
+                if (it.node_ == last.node_ && last.index_ == 0) {
+                    return last;
+                }
+            }
+        }
+
+    private:
+        friend class external_unrolled_list;
+        template<bool> friend class ul_paged_iterator;
+        template<bool> friend struct external_unrolled_list::ul_paged_segment_iterator;
+
+        using list_ptr = std::conditional_t<IsConst, const external_unrolled_list*, external_unrolled_list*>;
+
+        // Pins node unless it is the sentinel.
+        ul_paged_iterator(list_ptr list, NodeBase* node, const size_t index)
+        : list_(list), node_(node), index_(index) {
+            if (node_ != &list_->sentinel_) {
+                frame_ = list_->pin(static_cast<Node*>(node_));
+            }
+        }
+
+        // Moves to the front of the next node and reads further ahead.
+        void step_node() {
+            move_to(node_->next, 0);
+            if (frame_) {
+                list_->prefetch_after(static_cast<const Node*>(node_), list_->prefetch_nodes_);
+            }
+        }
+
+        void move_to(NodeBase* node, const size_t index) {
+            Frame* frame = node != &list_->sentinel_ ? list_->pin(static_cast<Node*>(node)) : nullptr;
+            if (frame_) {
+                --frame_->pins;
+            }
+            frame_ = frame;
+            node_ = node;
+            index_ = index;
+        }
+
+        list_ptr list_ = nullptr;
+        NodeBase* node_ = nullptr;
+        size_t index_ = 0;
+        Frame* frame_ = nullptr;
+    };
+
+    using iterator = ul_paged_iterator<false>;
+    using const_iterator = ul_paged_iterator<true>;
+
+    // Walks the list node by node; each node is one contiguous std::span, pinned while
+    // the segment iterator stays on it. Dereferencing a mutable one marks the block dirty.
+    template<bool IsConst>
+    struct ul_paged_segment_iterator {
+        using value_type = std::span<std::conditional_t<IsConst, const T, T>>;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::bidirectional_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+
+        // the first element of the node
+        ul_paged_iterator<IsConst> position;
+
+        value_type operator*() const {
+            if constexpr (!IsConst) {
+                position.frame_->dirty = true;
+            }
+            return value_type(position.frame_->data(), position.node_->node_size);
+        }
+
+        ul_paged_segment_iterator& operator++() {
+            position.step_node();
+            return *this;
+        }
+
+        ul_paged_segment_iterator operator++(int) {
+            ul_paged_segment_iterator temp = *this;
+            ++(*this);
+            return temp;
+        }
+
+        ul_paged_segment_iterator& operator--() {
+            position.move_to(position.node_->prev, 0);
+            return *this;
+        }
+
+        ul_paged_segment_iterator operator--(int) {
+            ul_paged_segment_iterator temp = *this;
+            --(*this);
+            return temp;
+        }
+
+        bool operator==(const ul_paged_segment_iterator& other) const noexcept {
+            return position == other.position;
+        }
+    };
+
+    using segment_iterator = ul_paged_segment_iterator<false>;
+    using const_segment_iterator = ul_paged_segment_iterator<true>;
+
+    // Creates (and immediately unlinks) the scratch file at path. Throws std::system_error
+    // if it cannot be created.
+    explicit external_unrolled_list(const std::filesystem::path& path, const size_t resident_limit = 1024,
+                                    const size_t prefetch_nodes = 4)
+    : resident_limit_(std::max<size_t>(resident_limit, 2)), prefetch_nodes_(prefetch_nodes) {
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+        if (fd_ < 0) {
+            throw std::system_error(errno, std::generic_category(), "external_unrolled_list: open");
+        }
+        ::unlink(path.c_str());
+    }
+
+    external_unrolled_list(const external_unrolled_list&) = delete;
+    external_unrolled_list& operator=(const external_unrolled_list&) = delete;
+
+    ~external_unrolled_list() {
+        clear();
+        if (reader_.joinable()) {
+            {
+                std::lock_guard lock(io_mutex_);
+                io_stop_ = true;
+            }
+            io_cv_.notify_all();
+            reader_.join();
+        }
+        while (lru_.next != &lru_) {
+            Frame* frame = static_cast<Frame*>(lru_.next);
+            unlink_frame(frame);
+            delete frame;
+        }
+        ::close(fd_);
+    }
+
+    iterator begin() {
+        iterator it(this, sentinel_.next, 0);
+        if (it.frame_) {
+            prefetch_after(static_cast<Node*>(sentinel_.next));
+        }
+        return it;
+    }
+
+    iterator end() {
+        return iterator(this, &sentinel_, 0);
+    }
+
+    const_iterator begin() const {
+        const_iterator it(this, sentinel_.next, 0);
+        if (it.frame_) {
+            prefetch_after(static_cast<Node*>(sentinel_.next));
+        }
+        return it;
+    }
+
+    const_iterator end() const {
+        return const_iterator(this, const_cast<NodeBase*>(&sentinel_), 0);
+    }
+
+    const_iterator cbegin() const {
+        return begin();
+    }
+
+    const_iterator cend() const {
+        return end();
+    }
+
+    std::ranges::subrange<segment_iterator> segments() {
+        return {segment_iterator{begin()}, segment_iterator{end()}};
+    }
+
+    std::ranges::subrange<const_segment_iterator> segments() const {
+        return {const_segment_iterator{begin()}, const_segment_iterator{end()}};
+    }
+
+    size_t size() const noexcept {
+        return size_;
+    }
+
+    bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+    T front() const {
+        return *begin();
+    }
+
+    T back() const {
+        return *std::prev(end());
+    }
+
+    // Walks the node sizes in memory and pages in only the node holding index.
+    T operator[](size_t index) const {
+        NodeBase* node = sentinel_.next;
+        while (index >= node->node_size) {
+            index -= node->node_size;
+            node = node->next;
+        }
+        Frame* frame = pin(static_cast<Node*>(node));
+        pin_guard guard{frame};
+        return frame->data()[index];
+    }
+
+    iterator insert(const const_iterator pos, const T& value) {
+        const T copy = value;
+        NodeBase* base = pos.node_;
+        size_t index = pos.index_;
+        // The front of a node, and the end of the list, belong to the end of the node before if it has room.
+        if (index == 0 && base->prev != &sentinel_ && base->prev->node_size < NodeMaxSize) {
+            base = base->prev;
+            index = base->node_size;
+        }
+        Node* node = base != &sentinel_ ? static_cast<Node*>(base) : create_node_after(sentinel_.prev);
+        pin_guard guard{pin(node)};
+        Frame* frame = node->frame;
+
+        if (node->node_size == NodeMaxSize) {
+            Node* split = create_node_after(node);
+            pin_guard split_guard{pin(split)};
+            const size_t keep = NodeMaxSize / 2;
+            std::memcpy(static_cast<void*>(split->frame->data()), frame->data() + keep, (NodeMaxSize - keep) * sizeof(T));
+            split->node_size = NodeMaxSize - keep;
+            node->node_size = keep;
+            if (index > keep) {
+                insert_in_node(split, index - keep, copy);
+                return iterator(this, split, index - keep);
+            }
+        }
+        insert_in_node(node, index, copy);
+        return iterator(this, node, index);
+    }
+
+    void push_back(const T& value) {
+        insert(cend(), value);
+    }
+
+    void push_front(const T& value) {
+        insert(cbegin(), value);
+    }
+
+    iterator erase(const const_iterator pos) {
+        Node* node = static_cast<Node*>(pos.node_);
+        const size_t index = pos.index_;
+        pin_guard guard{pin(node)};
+        T* data = node->frame->data();
+        std::memmove(static_cast<void*>(data + index), data + index + 1, (node->node_size - index - 1) * sizeof(T));
+        node->frame->dirty = true;
+        --node->node_size;
+        --size_;
+        if (node->node_size == 0) {
+            NodeBase* next = node->next;
+            delete_node(node);
+            return iterator(this, next, 0);
+        }
+        if (index == node->node_size) {
+            return iterator(this, node->next, 0);
+        }
+        return iterator(this, node, index);
+    }
+
+    void pop_back() {
+        erase(std::prev(cend()));
+    }
+
+    void pop_front() {
+        erase(cbegin());
+    }
+
+    // Drops every node and truncates the file; resident frames are kept for reuse.
+    void clear() noexcept {
+        NodeBase* node = sentinel_.next;
+        while (node != &sentinel_) {
+            NodeBase* next = node->next;
+            detach_frame(static_cast<Node*>(node));
+            delete static_cast<Node*>(node);
+            node = next;
+        }
+        sentinel_.next = sentinel_.prev = &sentinel_;
+        size_ = 0;
+        free_blocks_.clear();
+        block_count_ = 0;
+        [[maybe_unused]] const int result = ::ftruncate(fd_, 0);
+    }
+
+    // Writes every dirty resident block back to the file.
+    void flush() const {
+        for (FrameLink* link = lru_.next; link != &lru_; link = link->next) {
+            Frame* frame = static_cast<Frame*>(link);
+            if (frame->owner && frame->dirty) {
+                write_block(frame);
+            }
+        }
+    }
+
+    // Nodes whose block is in memory right now.
+    size_t resident_nodes() const noexcept {
+        size_t count = 0;
+        for (const FrameLink* link = lru_.next; link != &lru_; link = link->next) {
+            count += static_cast<const Frame*>(link)->owner != nullptr;
+        }
+        return count;
+    }
+
+    size_t resident_limit() const noexcept {
+        return resident_limit_;
+    }
+
+private:
+
+    void insert_in_node(Node* node, const size_t index, const T& value) noexcept {
+        T* data = node->frame->data();
+        std::memmove(static_cast<void*>(data + index + 1), data + index, (node->node_size - index) * sizeof(T));
+        std::memcpy(static_cast<void*>(data + index), &value, sizeof(T));
+        node->frame->dirty = true;
+        ++node->node_size;
+        ++size_;
+    }
+
+    // Makes node resident, loading its block into a frame if needed, and pins it. A read
+    // ahead still running is waited for; one that failed is redone here, to throw.
+    Frame* pin(Node* node) const {
+        Frame* frame = node->frame;
+        if (frame && frame->loading.load(std::memory_order_acquire)) {
+            wait_read(frame);
+        }
+        if (frame && frame->load_error != 0) {
+            detach_frame(node);
+            frame = nullptr;
+        }
+        if (frame == nullptr) {
+            frame = take_frame();
+            try {
+                read_block(node, frame);
+            } catch (...) {
+                make_oldest(frame);
+                throw;
+            }
+            frame->owner = node;
+            frame->dirty = false;
+            frame->load_error = 0;
+            node->frame = frame;
+        }
+        make_newest(frame);
+        ++frame->pins;
+        return frame;
+    }
+
+    // A frame with no owner: a free one, the least recently used unpinned one after
+    // writing it back, or a new one while under resident_limit or if all are pinned.
+    // Frames being read ahead are waited for before the pool grows. For a read ahead,
+    // may_grow is false and nullptr is returned where the pool would have to grow.
+    Frame* take_frame(const bool may_grow = true) const {
+        bool waited = false;
+        for (FrameLink* link = lru_.prev; link != &lru_; link = link->prev) {
+            Frame* frame = static_cast<Frame*>(link);
+            if (frame->pins != 0) {
+                continue;
+            }
+            if (frame->loading.load(std::memory_order_acquire)) {
+                if (frame_count_ < resident_limit_ || !may_grow || waited) {
+                    continue;
+                }
+                wait_reads();
+                waited = true;
+                link = &lru_;
+                continue;
+            }
+            if (frame->owner == nullptr) {
+                return frame;
+            }
+            if (frame_count_ < resident_limit_) {
+                break;
+            }
+            if (frame->dirty) {
+                write_block(frame);
+            }
+            frame->owner->frame = nullptr;
+            frame->owner = nullptr;
+            return frame;
+        }
+        if (!may_grow && frame_count_ >= resident_limit_) {
+            return nullptr;
+        }
+        Frame* frame = new Frame;
+        ++frame_count_;
+        make_oldest(frame);
+        return frame;
+    }
+
+    // Starts reading the blocks of the nodes from nearest to prefetch_nodes after node
+    // that are not resident. A scan moving by one node only needs the farthest one.
+    void prefetch_after(const Node* node, const size_t nearest = 1) const noexcept {
+        const NodeBase* ahead = node->next;
+        for (size_t distance = 1; distance <= prefetch_nodes_ && ahead != &sentinel_; ++distance, ahead = ahead->next) {
+            Node* next = const_cast<Node*>(static_cast<const Node*>(ahead));
+            if (distance >= nearest && next->frame == nullptr && !start_read(next)) {
+                return;
+            }
+        }
+    }
+
+    // Hands node's block to the reader thread, in a frame taken without growing the pool.
+    // Returns false if there is no such frame or the read cannot be queued.
+    bool start_read(Node* node) const noexcept {
+        Frame* frame;
+        try {
+            if (!reader_.joinable()) {
+                reader_ = std::thread([this] { read_ahead(); });
+            }
+            frame = take_frame(false);
+        } catch (...) {
+            return false;
+        }
+        if (frame == nullptr) {
+            return false;
+        }
+        frame->owner = node;
+        frame->dirty = false;
+        frame->load_block = node->block;
+        frame->load_bytes = node->node_size * sizeof(T);
+        frame->load_error = 0;
+        frame->loading.store(true, std::memory_order_relaxed);
+        node->frame = frame;
+        make_newest(frame);
+        try {
+            std::lock_guard lock(io_mutex_);
+            io_queue_.push_back(frame);
+            ++reads_in_flight_;
+        } catch (...) {
+            frame->loading.store(false, std::memory_order_relaxed);
+            detach_frame(node);
+            return false;
+        }
+        io_cv_.notify_all();
+        return true;
+    }
+
+    // Body of the reader thread: fills queued frames until the list is destroyed.
+    void read_ahead() const noexcept {
+        std::unique_lock lock(io_mutex_);
+        while (true) {
+            io_cv_.wait(lock, [this] { return io_stop_ || !io_queue_.empty(); });
+            if (io_queue_.empty()) {
+                return;
+            }
+            Frame* frame = io_queue_.front();
+            io_queue_.pop_front();
+            lock.unlock();
+            int error = 0;
+            try {
+                transfer(::pread, frame->storage, frame->load_bytes, frame->load_block, "external_unrolled_list: pread");
+            } catch (const std::system_error& e) {
+                error = e.code().value() != 0 ? e.code().value() : EIO;
+            }
+            lock.lock();
+            frame->load_error = error;
+            frame->loading.store(false, std::memory_order_release);
+            --reads_in_flight_;
+            io_cv_.notify_all();
+        }
+    }
+
+    void wait_read(Frame* frame) const noexcept {
+        std::unique_lock lock(io_mutex_);
+        io_cv_.wait(lock, [frame] { return !frame->loading.load(std::memory_order_acquire); });
+    }
+
+    void wait_reads() const noexcept {
+        std::unique_lock lock(io_mutex_);
+        io_cv_.wait(lock, [this] { return reads_in_flight_ == 0; });
+    }
+
+    Node* create_node_after(NodeBase* prev) {
+        Node* node = new Node;
+        try {
+            node->frame = take_frame();
+        } catch (...) {
+            delete node;
+            throw;
+        }
+        node->frame->owner = node;
+        node->frame->dirty = true;
+        node->frame->load_error = 0;
+        if (free_blocks_.empty()) {
+            node->block = block_count_++;
+        } else {
+            node->block = free_blocks_.back();
+            free_blocks_.pop_back();
+        }
+        node->prev = prev;
+        node->next = prev->next;
+        prev->next->prev = node;
+        prev->next = node;
+        return node;
+    }
+
+    void delete_node(Node* node) noexcept {
+        node->prev->next = node->next;
+        node->next->prev = node->prev;
+        detach_frame(node);
+        try {
+            free_blocks_.push_back(node->block);
+        } catch (...) {
+        }
+        delete node;
+    }
+
+    // The frame stays in the pool, oldest, for the next take_frame; pins of invalidated
+    // iterators on it are still released normally.
+    void detach_frame(Node* node) const noexcept {
+        if (Frame* frame = node->frame) {
+            if (frame->loading.load(std::memory_order_acquire)) {
+                wait_read(frame);
+            }
+            frame->owner = nullptr;
+            frame->dirty = false;
+            node->frame = nullptr;
+            make_oldest(frame);
+        }
+    }
+
+    void read_block(const Node* node, Frame* frame) const {
+        transfer(::pread, frame->storage, node->node_size * sizeof(T), node->block, "external_unrolled_list: pread");
+    }
+
+    void write_block(Frame* frame) const {
+        const Node* node = frame->owner;
+        transfer(::pwrite, frame->storage, node->node_size * sizeof(T), node->block, "external_unrolled_list: pwrite");
+        frame->dirty = false;
+    }
+
+    template<typename Call>
+    void transfer(Call call, std::byte* buffer, size_t bytes, const std::uint64_t block, const char* what) const {
+        off_t offset = static_cast<off_t>(block * block_bytes);
+        while (bytes != 0) {
+            const ssize_t done = call(fd_, buffer, bytes, offset);
+            if (done < 0 && errno == EINTR) {
+                continue;
+            }
+            if (done <= 0) {
+                throw std::system_error(done < 0 ? errno : EIO, std::generic_category(), what);
+            }
+            buffer += done;
+            bytes -= static_cast<size_t>(done);
+            offset += done;
+        }
+    }
+
+    void unlink_frame(FrameLink* frame) const noexcept {
+        frame->prev->next = frame->next;
+        frame->next->prev = frame->prev;
+    }
+
+    void make_newest(FrameLink* frame) const noexcept {
+        if (lru_.next == frame) {
+            return;
+        }
+        if (frame->next != frame) {
+            unlink_frame(frame);
+        }
+        frame->next = lru_.next;
+        frame->prev = &lru_;
+        lru_.next->prev = frame;
+        lru_.next = frame;
+    }
+
+    void make_oldest(FrameLink* frame) const noexcept {
+        if (frame->next != frame) {
+            unlink_frame(frame);
+        }
+        frame->prev = lru_.prev;
+        frame->next = &lru_;
+        lru_.prev->next = frame;
+        lru_.prev = frame;
+    }
+
+    NodeBase sentinel_;
+    size_t size_ = 0;
+    int fd_ = -1;
+    std::uint64_t block_count_ = 0;
+    std::vector<std::uint64_t> free_blocks_;
+    size_t resident_limit_;
+    size_t prefetch_nodes_;
+    // Paging changes the pool even on const access.
+    mutable FrameLink lru_;
+    mutable size_t frame_count_ = 0;
+    // Read ahead: frames queued for the reader thread, which is started on first use.
+    mutable std::mutex io_mutex_;
+    mutable std::condition_variable io_cv_;
+    mutable std::deque<Frame*> io_queue_;
+    mutable size_t reads_in_flight_ = 0;
+    mutable bool io_stop_ = false;
+    mutable std::thread reader_;
+};
@@ -0,0 +1,950 @@
+#pragma once
+#include "unrolled_list.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <utility>
+
+/*
+    Copy-on-write unrolled list. Nodes carry a reference count and are not linked to
+    each other; their order lives in a spine, a B+ tree of reference counted spine nodes
+    whose leaves are the list's nodes. Every spine node keeps, for each child, the number
+    of nodes and elements below it. Copying the list, or taking a snapshot(), shares the
+    spine root and costs O(1).
+
+    A change clones the spine nodes on the path to the node it writes to while they are
+    still shared, O(log n) of them, and clones that node too, so the writer pays only for
+    what it touches and the other copies keep seeing the old spine and nodes. Reference
+    counts are atomic: snapshots may be read and dropped on other threads while the writer
+    keeps changing the list. A single list object is not safe to change concurrently.
+
+    Element access is read-only, so that a write cannot bypass the cloning; use edit()
+    to get a writable element. Changes invalidate all iterators of the list changed.
+    Insertions give the strong guarantee unless a move of T throws.
+*/
+template<typename T, size_t NodeMaxSize = 64, typename Allocator = std::allocator<T>>
+class persistent_unrolled_list {
+    static_assert(NodeMaxSize > 1, "persistent_unrolled_list splits nodes, so they need room for two elements");
+
+    struct Shared {
+        std::atomic<size_t> refs = 1;
+    };
+
+    struct Node : Shared {
+        size_t node_size = 0;
+        alignas(T) unsigned char storage[sizeof(T) * NodeMaxSize];
+
+        // User-provided, so that value-initialization does not zero the storage.
+        Node() noexcept {}
+
+        T* data() noexcept {
+            return std::launder(reinterpret_cast<T*>(storage));
+        }
+
+        const T* data() const noexcept {
+            return std::launder(reinterpret_cast<const T*>(storage));
+        }
+    };
+
+    static constexpr size_t spine_fanout = 32;
+    // Spine nodes other than the root keep at least spine_fanout / 2 children, so this
+    // is more levels than any list that fits into memory needs.
+    static constexpr size_t spine_max_height = 24;
+
+    // Children are Nodes in the lowest spine level and spine nodes above it.
+    struct Spine : Shared {
+        size_t count = 0;
+        Shared* children[spine_fanout];
+        size_t leaves[spine_fanout];
+        size_t elements[spine_fanout];
+
+        Spine() noexcept {}
+    };
+
+    using t_allocator_traits = std::allocator_traits<Allocator>;
+    using node_allocator = typename t_allocator_traits::template rebind_alloc<Node>;
+    using node_allocator_traits = std::allocator_traits<node_allocator>;
+    using spine_allocator = typename t_allocator_traits::template rebind_alloc<Spine>;
+    using spine_allocator_traits = std::allocator_traits<spine_allocator>;
+
+    struct leaf_position {
+        const Spine* bottom = nullptr;
+        size_t child = 0;
+    };
+
+    // Finds the leaf-th node in list order, or nothing if there are not that many.
+    static leaf_position find_leaf(const Spine* root, const size_t height, size_t leaf) noexcept {
+        if (root == nullptr) {
+            return {};
+        }
+        const Spine* spine = root;
+        for (size_t level = 0; level + 1 < height; ++level) {
+            size_t j = 0;
+            while (j < spine->count && leaf >= spine->leaves[j]) {
+                leaf -= spine->leaves[j];
+                ++j;
+            }
+            if (j == spine->count) {
+                return {};
+            }
+            spine = static_cast<const Spine*>(spine->children[j]);
+        }
+        if (leaf >= spine->count) {
+            return {};
+        }
+        return {spine, leaf};
+    }
+
+public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+
+    class const_iterator {
+    public:
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using reference = const T&;
+        using pointer = const T*;
+        using iterator_category = std::bidirectional_iterator_tag;
+
+        const_iterator() = default;
+
+        reference operator*() const {
+            return node()->data()[index_];
+        }
+
+        pointer operator->() const {
+            return node()->data() + index_;
+        }
+
+        const_iterator& operator++() {
+            if (++index_ == node()->node_size) {
+                next_node();
+                index_ = 0;
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator temp = *this;
+            ++(*this);
+            return temp;
+        }
+
+        const_iterator& operator--() {
+            if (index_ == 0) {
+                prev_node();
+                index_ = node()->node_size;
+            }
+            --index_;
+            return *this;
+        }
+
+        const_iterator operator--(int) {
+            const_iterator temp = *this;
+            --(*this);
+            return temp;
+        }
+
+        bool operator==(const const_iterator& other) const noexcept {
+            return leaf_ == other.leaf_ && index_ == other.index_;
+        }
+
+    private:
+        friend class persistent_unrolled_list;
+
+        const_iterator(const Spine* root, const size_t height, const size_t leaf, const size_t index) noexcept
+        : root_(root), height_(height), leaf_(leaf), index_(index) {
+            const leaf_position position = find_leaf(root, height, leaf);
+            bottom_ = position.bottom;
+            child_ = position.child;
+        }
+
+        const Node* node() const noexcept {
+            return static_cast<const Node*>(bottom_->children[child_]);
+        }
+
+        // Moves within the lowest spine node while it can, and descends from the root
+        // only when crossing into the next one.
+        void next_node() noexcept {
+            ++leaf_;
+            if (bottom_ && child_ + 1 < bottom_->count) {
+                ++child_;
+                return;
+            }
+            const leaf_position position = find_leaf(root_, height_, leaf_);
+            bottom_ = position.bottom;
+            child_ = position.child;
+        }
+
+        void prev_node() noexcept {
+            --leaf_;
+            if (bottom_ && child_ > 0) {
+                --child_;
+                return;
+            }
+            const leaf_position position = find_leaf(root_, height_, leaf_);
+            bottom_ = position.bottom;
+            child_ = position.child;
+        }
+
+        const Spine* root_ = nullptr;
+        size_t height_ = 0;
+        size_t leaf_ = 0;
+        const Spine* bottom_ = nullptr;
+        size_t child_ = 0;
+        size_t index_ = 0;
+    };
+
+    using iterator = const_iterator;
+    using reverse_iterator = std::reverse_iterator<const_iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    // Walks the list node by node; each node is one contiguous std::span.
+    struct const_segment_iterator {
+        using value_type = std::span<const T>;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::bidirectional_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+
+        // the first element of the node
+        const_iterator position;
+
+        value_type operator*() const {
+            const Node* node = position.node();
+            return value_type(node->data(), node->node_size);
+        }
+
+        const_segment_iterator& operator++() {
+            position.next_node();
+            return *this;
+        }
+
+        const_segment_iterator operator++(int) {
+            const_segment_iterator temp = *this;
+            position.next_node();
+            return temp;
+        }
+
+        const_segment_iterator& operator--() {
+            position.prev_node();
+            return *this;
+        }
+
+        const_segment_iterator operator--(int) {
+            const_segment_iterator temp = *this;
+            position.prev_node();
+            return temp;
+        }
+
+        bool operator==(const const_segment_iterator& other) const = default;
+    };
+
+    // Read-only view of the list as it was when snapshot() was called.
+    class snapshot_type {
+    public:
+        using value_type = T;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = const T&;
+        using const_reference = const T&;
+        using iterator = typename persistent_unrolled_list::const_iterator;
+        using const_iterator = typename persistent_unrolled_list::const_iterator;
+
+        const_iterator begin() const noexcept { return list_.begin(); }
+        const_iterator end() const noexcept { return list_.end(); }
+        const_iterator cbegin() const noexcept { return list_.begin(); }
+        const_iterator cend() const noexcept { return list_.end(); }
+        const_reverse_iterator rbegin() const noexcept { return list_.rbegin(); }
+        const_reverse_iterator rend() const noexcept { return list_.rend(); }
+
+        size_t size() const noexcept { return list_.size(); }
+        bool empty() const noexcept { return list_.empty(); }
+        const T& front() const { return list_.front(); }
+        const T& back() const { return list_.back(); }
+        const T& operator[](const size_t index) const { return list_[index]; }
+
+        std::ranges::subrange<const_segment_iterator> segments() const noexcept {
+            return list_.segments();
+        }
+
+        bool operator==(const snapshot_type& other) const = default;
+
+    private:
+        friend class persistent_unrolled_list;
+
+        explicit snapshot_type(const persistent_unrolled_list& list) noexcept : list_(list) {}
+
+        persistent_unrolled_list list_;
+    };
+
+    explicit persistent_unrolled_list(const allocator_type& alloc = allocator_type())
+    : t_alloc_(alloc), node_alloc_(alloc), spine_alloc_(alloc) {
+    }
+
+    persistent_unrolled_list(std::initializer_list<T> init, const allocator_type& alloc = allocator_type())
+    : persistent_unrolled_list(init.begin(), init.end(), alloc) {
+    }
+
+    template<std::input_iterator InputIt>
+    persistent_unrolled_list(InputIt first, const InputIt last, const allocator_type& alloc = allocator_type())
+    : persistent_unrolled_list(alloc) {
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
+    }
+
+    // Shares the nodes of other, and with them its allocator.
+    persistent_unrolled_list(const persistent_unrolled_list& other) noexcept
+    : t_alloc_(other.t_alloc_), node_alloc_(other.node_alloc_), spine_alloc_(other.spine_alloc_)
+    , root_(other.root_), height_(other.height_), leaves_(other.leaves_), size_(other.size_) {
+        if (root_) {
+            root_->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    persistent_unrolled_list(persistent_unrolled_list&& other) noexcept
+    : t_alloc_(other.t_alloc_), node_alloc_(other.node_alloc_), spine_alloc_(other.spine_alloc_)
+    , root_(std::exchange(other.root_, nullptr)), height_(std::exchange(other.height_, 0))
+    , leaves_(std::exchange(other.leaves_, 0)), size_(std::exchange(other.size_, 0)) {
+    }
+
+    persistent_unrolled_list& operator=(const persistent_unrolled_list& other) noexcept {
+        persistent_unrolled_list(other).swap(*this);
+        return *this;
+    }
+
+    persistent_unrolled_list& operator=(persistent_unrolled_list&& other) noexcept {
+        persistent_unrolled_list(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    ~persistent_unrolled_list() {
+        release_spine(root_, height_);
+    }
+
+    void swap(persistent_unrolled_list& other) noexcept {
+        using std::swap;
+        swap(t_alloc_, other.t_alloc_);
+        swap(node_alloc_, other.node_alloc_);
+        swap(spine_alloc_, other.spine_alloc_);
+        swap(root_, other.root_);
+        swap(height_, other.height_);
+        swap(leaves_, other.leaves_);
+        swap(size_, other.size_);
+    }
+
+    friend void swap(persistent_unrolled_list& lhs, persistent_unrolled_list& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return t_alloc_;
+    }
+
+    // O(1): shares the spine, nothing is copied until the list changes.
+    snapshot_type snapshot() const noexcept {
+        return snapshot_type(*this);
+    }
+
+    const_iterator begin() const noexcept {
+        return iterator_at(0, 0);
+    }
+
+    const_iterator end() const noexcept {
+        return iterator_at(leaves_, 0);
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    std::ranges::subrange<const_segment_iterator> segments() const noexcept {
+        return {const_segment_iterator{begin()}, const_segment_iterator{end()}};
+    }
+
+    size_t size() const noexcept {
+        return size_;
+    }
+
+    bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+    const T& front() const {
+        return *begin();
+    }
+
+    const T& back() const {
+        return *std::prev(end());
+    }
+
+    // Descends the spine by element counts, O(log n).
+    const T& operator[](size_t index) const {
+        const Spine* spine = root_;
+        for (size_t level = 0; ; ++level) {
+            size_t j = 0;
+            while (index >= spine->elements[j]) {
+                index -= spine->elements[j];
+                ++j;
+            }
+            if (level + 1 == height_) {
+                return static_cast<const Node*>(spine->children[j])->data()[index];
+            }
+            spine = static_cast<const Spine*>(spine->children[j]);
+        }
+    }
+
+    // Clones the node of pos, and the spine above it, if they are shared and returns its
+    // element for writing. The reference stays valid until the next change to the list.
+    T& edit(const const_iterator pos) {
+        spine_path path;
+        own_path(pos.leaf_, path);
+        return own_node(path)->data()[pos.index_];
+    }
+
+    template<typename... Args>
+    const_iterator emplace(const const_iterator pos, Args&&... args) {
+        size_t leaf = pos.leaf_;
+        size_t index = pos.index_;
+        T value(std::forward<Args>(args)...);
+        if (root_ == nullptr) {
+            root_ = new_spine();
+            height_ = 1;
+        }
+
+        // The front of a node, and the end of the list, belong to the end of the node before if it has room.
+        if (index == 0 && leaf != 0) {
+            const leaf_position before = find_leaf(root_, height_, leaf - 1);
+            const size_t before_size = static_cast<const Node*>(before.bottom->children[before.child])->node_size;
+            if (before_size < NodeMaxSize) {
+                --leaf;
+                index = before_size;
+            }
+        }
+
+        spine_path path;
+        own_path(leaf, path);
+        if (leaf == leaves_) {
+            spine_reserve reserve;
+            reserve_for_insert(path, reserve);
+            Node* node = nullptr;
+            try {
+                node = new_node();
+                t_allocator_traits::construct(t_alloc_, node->data(), std::move(value));
+            } catch (...) {
+                if (node) {
+                    delete_node(node);
+                }
+                free_reserve(reserve);
+                throw;
+            }
+            node->node_size = 1;
+            insert_leaf(path, reserve, node, 1);
+        } else {
+            Node* node = own_node(path);
+            if (node->node_size == NodeMaxSize) {
+                split_node(path, node);
+                if (index > node->node_size) {
+                    index -= node->node_size;
+                    ++leaf;
+                }
+                own_path(leaf, path);
+                node = bottom_node(path);
+            }
+            const size_t old_size = node->node_size;
+            try {
+                insert_in_node(node, index, std::move(value));
+            } catch (...) {
+                if (node->node_size != old_size) {
+                    add_elements(path, 1);
+                    ++size_;
+                }
+                throw;
+            }
+            add_elements(path, 1);
+        }
+        ++size_;
+        return iterator_at(leaf, index);
+    }
+
+    const_iterator insert(const const_iterator pos, const T& value) {
+        return emplace(pos, value);
+    }
+
+    const_iterator insert(const const_iterator pos, T&& value) {
+        return emplace(pos, std::move(value));
+    }
+
+    template<typename... Args>
+    T& emplace_back(Args&&... args) {
+        return edit(emplace(end(), std::forward<Args>(args)...));
+    }
+
+    template<typename... Args>
+    T& emplace_front(Args&&... args) {
+        return edit(emplace(begin(), std::forward<Args>(args)...));
+    }
+
+    void push_back(const T& value) {
+        emplace(end(), value);
+    }
+
+    void push_back(T&& value) {
+        emplace(end(), std::move(value));
+    }
+
+    void push_front(const T& value) {
+        emplace(begin(), value);
+    }
+
+    void push_front(T&& value) {
+        emplace(begin(), std::move(value));
+    }
+
+    const_iterator erase(const const_iterator pos) {
+        const size_t leaf = pos.leaf_;
+        const size_t index = pos.index_;
+        spine_path path;
+        own_path(leaf, path);
+
+        if (bottom_node(path)->node_size == 1) {
+            remove_leaf(path);
+            --size_;
+            return iterator_at(leaf, 0);
+        }
+
+        Node* node = own_node(path);
+        T* data = node->data();
+        std::move(data + index + 1, data + node->node_size, data + index);
+        t_allocator_traits::destroy(t_alloc_, data + node->node_size - 1);
+        --node->node_size;
+        add_elements(path, -1);
+        --size_;
+        if (index == node->node_size) {
+            return iterator_at(leaf + 1, 0);
+        }
+        return iterator_at(leaf, index);
+    }
+
+    void pop_back() {
+        erase(std::prev(end()));
+    }
+
+    void pop_front() {
+        erase(begin());
+    }
+
+    void clear() noexcept {
+        release_spine(std::exchange(root_, nullptr), std::exchange(height_, 0));
+        leaves_ = 0;
+        size_ = 0;
+    }
+
+    friend bool operator==(const persistent_unrolled_list& lhs, const persistent_unrolled_list& rhs) {
+        return lhs.size_ == rhs.size_ && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+private:
+
+    // Spine nodes from the root down to a node, and the child taken in each; the child
+    // in the lowest one is the node's position there.
+    struct spine_path {
+        Spine* spines[spine_max_height];
+        size_t children[spine_max_height];
+    };
+
+    // Spine nodes allocated up front, so that linking a node in cannot fail halfway.
+    struct spine_reserve {
+        Spine* spines[spine_max_height + 1];
+        size_t count = 0;
+    };
+
+    const_iterator iterator_at(const size_t leaf, const size_t index) const noexcept {
+        return const_iterator(root_, height_, leaf, index);
+    }
+
+    Node* bottom_node(const spine_path& path) const noexcept {
+        return static_cast<Node*>(path.spines[height_ - 1]->children[path.children[height_ - 1]]);
+    }
+
+    static size_t total(const size_t* counts, const size_t count) noexcept {
+        return std::accumulate(counts, counts + count, size_t{0});
+    }
+
+    // Makes the spine nodes down to the leaf-th node exclusive to this list, cloning the
+    // shared ones, and records the path. leaf may equal leaves_, the end of the list. A
+    // clone that throws leaves the list as it was: the ones made so far are equal copies.
+    void own_path(size_t leaf, spine_path& path) {
+        if (root_->refs.load(std::memory_order_acquire) != 1) {
+            root_ = clone_spine(root_, height_);
+        }
+        Spine* spine = root_;
+        for (size_t level = 0; level + 1 < height_; ++level) {
+            size_t j = 0;
+            while (j + 1 < spine->count && leaf >= spine->leaves[j]) {
+                leaf -= spine->leaves[j];
+                ++j;
+            }
+            path.spines[level] = spine;
+            path.children[level] = j;
+            Shared*& child = spine->children[j];
+            if (child->refs.load(std::memory_order_acquire) != 1) {
+                child = clone_spine(static_cast<Spine*>(child), height_ - level - 1);
+            }
+            spine = static_cast<Spine*>(child);
+        }
+        path.spines[height_ - 1] = spine;
+        path.children[height_ - 1] = leaf;
+    }
+
+    // Returns an exclusive copy of spine and drops this list's reference to it. A count of
+    // one can only be seen by the last owner, and the acquire before the call orders it
+    // after the other owners' releases.
+    Spine* clone_spine(Spine* spine, const size_t height) {
+        Spine* copy = new_spine();
+        copy->count = spine->count;
+        std::copy_n(spine->children, spine->count, copy->children);
+        std::copy_n(spine->leaves, spine->count, copy->leaves);
+        std::copy_n(spine->elements, spine->count, copy->elements);
+        for (size_t i = 0; i < copy->count; ++i) {
+            copy->children[i]->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+        release_spine(spine, height);
+        return copy;
+    }
+
+    // The path is owned; clones the node at its end if another spine still refers to it.
+    Node* own_node(const spine_path& path) {
+        Shared*& slot = path.spines[height_ - 1]->children[path.children[height_ - 1]];
+        Node* node = static_cast<Node*>(slot);
+        if (node->refs.load(std::memory_order_acquire) == 1) {
+            return node;
+        }
+        Node* copy = new_node();
+        T* data = copy->data();
+        try {
+            for (; copy->node_size < node->node_size; ++copy->node_size) {
+                t_allocator_traits::construct(t_alloc_, data + copy->node_size, node->data()[copy->node_size]);
+            }
+        } catch (...) {
+            delete_node(copy);
+            throw;
+        }
+        slot = copy;
+        release_node(node);
+        return copy;
+    }
+
+    void add_elements(const spine_path& path, const std::ptrdiff_t delta) noexcept {
+        for (size_t level = 0; level < height_; ++level) {
+            path.spines[level]->elements[path.children[level]] += static_cast<size_t>(delta);
+        }
+    }
+
+    // Allocates a spine node for every full one an insertion at path splits: the full
+    // ones right above the nodes, and a new root if all of them are full.
+    void reserve_for_insert(const spine_path& path, spine_reserve& reserve) {
+        size_t needed = 0;
+        while (needed < height_ && path.spines[height_ - 1 - needed]->count == spine_fanout) {
+            ++needed;
+        }
+        if (needed == height_) {
+            ++needed;
+        }
+        try {
+            while (reserve.count < needed) {
+                reserve.spines[reserve.count++] = new_spine();
+            }
+        } catch (...) {
+            free_reserve(reserve);
+            throw;
+        }
+    }
+
+    void free_reserve(spine_reserve& reserve) noexcept {
+        while (reserve.count) {
+            delete_spine(reserve.spines[--reserve.count]);
+        }
+    }
+
+    static void insert_child(Spine* spine, const size_t position, Shared* child,
+                             const size_t leaves, const size_t elements) noexcept {
+        std::copy_backward(spine->children + position, spine->children + spine->count, spine->children + spine->count + 1);
+        std::copy_backward(spine->leaves + position, spine->leaves + spine->count, spine->leaves + spine->count + 1);
+        std::copy_backward(spine->elements + position, spine->elements + spine->count, spine->elements + spine->count + 1);
+        spine->children[position] = child;
+        spine->leaves[position] = leaves;
+        spine->elements[position] = elements;
+        ++spine->count;
+    }
+
+    static void remove_child(Spine* spine, const size_t position) noexcept {
+        std::copy(spine->children + position + 1, spine->children + spine->count, spine->children + position);
+        std::copy(spine->leaves + position + 1, spine->leaves + spine->count, spine->leaves + position);
+        std::copy(spine->elements + position + 1, spine->elements + spine->count, spine->elements + position);
+        --spine->count;
+    }
+
+    // Moves children [first, first + count) of from to position of to.
+    static void move_children(Spine* from, const size_t first, const size_t count, Spine* to, const size_t position) noexcept {
+        const auto move = [=](auto* from_array, auto* to_array) {
+            std::copy_backward(to_array + position, to_array + to->count, to_array + to->count + count);
+            std::copy_n(from_array + first, count, to_array + position);
+            std::copy(from_array + first + count, from_array + from->count, from_array + first);
+        };
+        move(from->children, to->children);
+        move(from->leaves, to->leaves);
+        move(from->elements, to->elements);
+        to->count += count;
+        from->count -= count;
+    }
+
+    // Links node, holding elements, in before the position path ends at. Full spine nodes
+    // on the way up are split in half into the reserved ones.
+    void insert_leaf(const spine_path& path, spine_reserve& reserve, Node* node, const size_t elements) noexcept {
+        Shared* carry = node;
+        size_t carry_leaves = 1;
+        size_t carry_elements = elements;
+        size_t position = path.children[height_ - 1];
+        size_t used = 0;
+        ++leaves_;
+        for (size_t level = height_; level-- > 0; ) {
+            Spine* spine = path.spines[level];
+            if (spine->count < spine_fanout) {
+                insert_child(spine, position, carry, carry_leaves, carry_elements);
+                for (size_t up = level; up-- > 0; ) {
+                    path.spines[up]->leaves[path.children[up]] += 1;
+                    path.spines[up]->elements[path.children[up]] += elements;
+                }
+                return;
+            }
+
+            constexpr size_t half = spine_fanout / 2;
+            Spine* right = reserve.spines[used++];
+            move_children(spine, half, spine_fanout - half, right, 0);
+            if (position <= half) {
+                insert_child(spine, position, carry, carry_leaves, carry_elements);
+            } else {
+                insert_child(right, position - half, carry, carry_leaves, carry_elements);
+            }
+            carry = right;
+            carry_leaves = total(right->leaves, right->count);
+            carry_elements = total(right->elements, right->count);
+
+            if (level == 0) {
+                Spine* root = reserve.spines[used++];
+                insert_child(root, 0, spine, total(spine->leaves, spine->count), total(spine->elements, spine->count));
+                insert_child(root, 1, right, carry_leaves, carry_elements);
+                root_ = root;
+                ++height_;
+                return;
+            }
+            Spine* parent = path.spines[level - 1];
+            const size_t child = path.children[level - 1];
+            parent->leaves[child] = total(spine->leaves, spine->count);
+            parent->elements[child] = total(spine->elements, spine->count);
+            position = child + 1;
+        }
+    }
+
+    // Unlinks and releases the one-element node the owned path ends at.
+    void remove_leaf(const spine_path& path) noexcept {
+        Spine* bottom = path.spines[height_ - 1];
+        const size_t child = path.children[height_ - 1];
+        release_node(static_cast<Node*>(bottom->children[child]));
+        remove_child(bottom, child);
+        for (size_t level = 0; level + 1 < height_; ++level) {
+            path.spines[level]->leaves[path.children[level]] -= 1;
+            path.spines[level]->elements[path.children[level]] -= 1;
+        }
+        --leaves_;
+        rebalance(path);
+    }
+
+    // Refills spine nodes on the path that fell below half of spine_fanout from a
+    // sibling, merging the two if they fit into one, and drops roots with a single child.
+    void rebalance(const spine_path& path) noexcept {
+        for (size_t level = height_ - 1; level > 0; --level) {
+            Spine* spine = path.spines[level];
+            if (spine->count >= spine_fanout / 2) {
+                break;
+            }
+            Spine* parent = path.spines[level - 1];
+            const size_t child = path.children[level - 1];
+            const size_t left_child = child > 0 ? child - 1 : child;
+            const size_t height = height_ - level;
+            Shared*& sibling = parent->children[child > 0 ? child - 1 : child + 1];
+            if (sibling->refs.load(std::memory_order_acquire) != 1) {
+                try {
+                    sibling = clone_spine(static_cast<Spine*>(sibling), height);
+                } catch (...) {
+                    // an underfull spine node is only slower, so it can stay
+                    break;
+                }
+            }
+            Spine* left = static_cast<Spine*>(parent->children[left_child]);
+            Spine* right = static_cast<Spine*>(parent->children[left_child + 1]);
+            if (left->count + right->count <= spine_fanout) {
+                move_children(right, 0, right->count, left, left->count);
+                parent->leaves[left_child] += parent->leaves[left_child + 1];
+                parent->elements[left_child] += parent->elements[left_child + 1];
+                remove_child(parent, left_child + 1);
+                delete_spine(right);
+                continue;
+            }
+            const size_t target = (left->count + right->count) / 2;
+            if (left->count < target) {
+                move_children(right, 0, target - left->count, left, left->count);
+            } else {
+                move_children(left, target, left->count - target, right, 0);
+            }
+            parent->leaves[left_child] = total(left->leaves, left->count);
+            parent->elements[left_child] = total(left->elements, left->count);
+            parent->leaves[left_child + 1] = total(right->leaves, right->count);
+            parent->elements[left_child + 1] = total(right->elements, right->count);
+            break;
+        }
+
+        while (height_ > 1 && root_->count == 1) {
+            Spine* root = root_;
+            root_ = static_cast<Spine*>(root->children[0]);
+            --height_;
+            delete_spine(root);
+        }
+        if (root_->count == 0) {
+            delete_spine(std::exchange(root_, nullptr));
+            height_ = 0;
+        }
+    }
+
+    // Moves the upper half of the owned, full node at the end of path into a new node
+    // after it.
+    void split_node(const spine_path& path, Node* node) {
+        spine_reserve reserve;
+        reserve_for_insert(path, reserve);
+        Node* split;
+        try {
+            split = new_node();
+        } catch (...) {
+            free_reserve(reserve);
+            throw;
+        }
+        const size_t keep = NodeMaxSize / 2;
+        T* data = node->data();
+        try {
+            for (; split->node_size < NodeMaxSize - keep; ++split->node_size) {
+                t_allocator_traits::construct(t_alloc_, split->data() + split->node_size,
+                                              std::move_if_noexcept(data[keep + split->node_size]));
+            }
+        } catch (...) {
+            delete_node(split);
+            free_reserve(reserve);
+            throw;
+        }
+        for (size_t i = keep; i < NodeMaxSize; ++i) {
+            t_allocator_traits::destroy(t_alloc_, data + i);
+        }
+        node->node_size = keep;
+        add_elements(path, -static_cast<std::ptrdiff_t>(NodeMaxSize - keep));
+
+        spine_path after = path;
+        ++after.children[height_ - 1];
+        insert_leaf(after, reserve, split, NodeMaxSize - keep);
+    }
+
+    void insert_in_node(Node* node, const size_t index, T&& value) {
+        T* data = node->data();
+        const size_t node_size = node->node_size;
+        if (index < node_size) {
+            t_allocator_traits::construct(t_alloc_, data + node_size, std::move(data[node_size - 1]));
+            ++node->node_size;
+            std::move_backward(data + index, data + node_size - 1, data + node_size);
+            data[index] = std::move(value);
+        } else {
+            t_allocator_traits::construct(t_alloc_, data + node_size, std::move(value));
+            ++node->node_size;
+        }
+    }
+
+    Node* new_node() {
+        Node* node = node_allocator_traits::allocate(node_alloc_, 1);
+        node_allocator_traits::construct(node_alloc_, node);
+        return node;
+    }
+
+    void delete_node(Node* node) noexcept {
+        for (size_t i = 0; i < node->node_size; ++i) {
+            t_allocator_traits::destroy(t_alloc_, node->data() + i);
+        }
+        node_allocator_traits::destroy(node_alloc_, node);
+        node_allocator_traits::deallocate(node_alloc_, node, 1);
+    }
+
+    void release_node(Node* node) noexcept {
+        if (node->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete_node(node);
+        }
+    }
+
+    Spine* new_spine() {
+        Spine* spine = spine_allocator_traits::allocate(spine_alloc_, 1);
+        spine_allocator_traits::construct(spine_alloc_, spine);
+        return spine;
+    }
+
+    // Frees the spine node alone; its children have been moved elsewhere.
+    void delete_spine(Spine* spine) noexcept {
+        spine_allocator_traits::destroy(spine_alloc_, spine);
+        spine_allocator_traits::deallocate(spine_alloc_, spine, 1);
+    }
+
+    // height is the number of spine levels from spine down to the nodes.
+    void release_spine(Spine* spine, const size_t height) noexcept {
+        if (spine == nullptr || spine->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+        for (size_t i = 0; i < spine->count; ++i) {
+            if (height == 1) {
+                release_node(static_cast<Node*>(spine->children[i]));
+            } else {
+                release_spine(static_cast<Spine*>(spine->children[i]), height - 1);
+            }
+        }
+        delete_spine(spine);
+    }
+
+    [[no_unique_address]] allocator_type t_alloc_;
+    [[no_unique_address]] node_allocator node_alloc_;
+    [[no_unique_address]] spine_allocator spine_alloc_;
+    Spine* root_ = nullptr;
+    // number of spine levels
+    size_t height_ = 0;
+    // number of nodes
+    size_t leaves_ = 0;
+    size_t size_ = 0;
+};
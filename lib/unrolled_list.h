@@ -1,41 +1,364 @@
 #pragma once
 #include <random>
 #include <ranges>
+#include <algorithm>
 #include <iostream>
+#include <new>
+#include <cstddef>
+#include <stdexcept>
+#include <span>
+#include <numeric>
+#include <iterator>
+#include <array>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+
+struct ul_no_index {
+    static constexpr bool indexed = false;
+
+    template<typename Node>
+    struct node_hook {};
+
+    template<typename Node>
+    struct tree {
+        void on_link(Node*, Node*) noexcept {}
+        void on_unlink(Node*) noexcept {}
+        void on_resize(Node*) noexcept {}
+        void reset() noexcept {}
+    };
+};
+
+struct ul_order_statistics_index {
+    static constexpr bool indexed = true;
+
+    template<typename Node>
+    struct node_hook {
+        Node* parent = nullptr;
+        Node* left = nullptr;
+        Node* right = nullptr;
+        size_t subtree_size = 0;
+        size_t priority = 0;
+    };
+
+    // Treap over the node chain in list order, keyed implicitly by position and
+    // augmented with per-subtree element counts.
+    template<typename Node>
+    struct tree {
+        Node* root = nullptr;
+        size_t seed = 0x9E3779B97F4A7C15ull;
+
+        static size_t subtree(const Node* node) noexcept {
+            return node ? node->hook.subtree_size : 0;
+        }
+
+        static void pull(Node* node) noexcept {
+            node->hook.subtree_size = subtree(node->hook.left) + subtree(node->hook.right) + node->node_size;
+        }
+
+        static void pull_up(Node* node) noexcept {
+            for (; node; node = node->hook.parent) {
+                pull(node);
+            }
+        }
+
+        void replace_child(Node* parent, Node* old_child, Node* new_child) noexcept {
+            if (parent == nullptr) {
+                root = new_child;
+            } else if (parent->hook.left == old_child) {
+                parent->hook.left = new_child;
+            } else {
+                parent->hook.right = new_child;
+            }
+            if (new_child) {
+                new_child->hook.parent = parent;
+            }
+        }
+
+        void rotate_up(Node* node) noexcept {
+            Node* parent = node->hook.parent;
+            Node* grand_parent = parent->hook.parent;
+            if (parent->hook.left == node) {
+                parent->hook.left = node->hook.right;
+                if (node->hook.right) {
+                    node->hook.right->hook.parent = parent;
+                }
+                node->hook.right = parent;
+            } else {
+                parent->hook.right = node->hook.left;
+                if (node->hook.left) {
+                    node->hook.left->hook.parent = parent;
+                }
+                node->hook.left = parent;
+            }
+            parent->hook.parent = node;
+            replace_child(grand_parent, parent, node);
+            pull(parent);
+            pull(node);
+        }
+
+        // predecessor is the previous node in list order, nullptr for the first one.
+        void on_link(Node* node, Node* predecessor) noexcept {
+            node->hook = {};
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            node->hook.priority = seed;
+
+            Node* parent = predecessor;
+            if (root == nullptr) {
+                root = node;
+            } else {
+                if (parent == nullptr) {
+                    parent = root;
+                } else if (parent->hook.right != nullptr) {
+                    parent = parent->hook.right;
+                } else {
+                    parent->hook.right = node;
+                }
+                if (parent->hook.right != node) {
+                    while (parent->hook.left) {
+                        parent = parent->hook.left;
+                    }
+                    parent->hook.left = node;
+                }
+                node->hook.parent = parent;
+            }
+            pull_up(node);
+            while (node->hook.parent && node->hook.parent->hook.priority < node->hook.priority) {
+                rotate_up(node);
+            }
+        }
+
+        void on_unlink(Node* node) noexcept {
+            while (node->hook.left && node->hook.right) {
+                rotate_up(node->hook.left->hook.priority > node->hook.right->hook.priority
+                    ? node->hook.left : node->hook.right);
+            }
+            Node* parent = node->hook.parent;
+            replace_child(parent, node, node->hook.left ? node->hook.left : node->hook.right);
+            pull_up(parent);
+        }
+
+        void on_resize(Node* node) noexcept {
+            pull_up(node);
+        }
+
+        void reset() noexcept {
+            root = nullptr;
+        }
+
+        static Node* find(Node* node, size_t& position) noexcept {
+            while (node) {
+                const size_t left_size = subtree(node->hook.left);
+                if (position < left_size) {
+                    node = node->hook.left;
+                } else if (position < left_size + node->node_size) {
+                    position -= left_size;
+                    return node;
+                } else {
+                    position -= left_size + node->node_size;
+                    node = node->hook.right;
+                }
+            }
+            return nullptr;
+        }
+
+        static Node* last(Node* node) noexcept {
+            while (node->hook.right) {
+                node = node->hook.right;
+            }
+            return node;
+        }
+
+        static Node* root_of(Node* node) noexcept {
+            while (node->hook.parent) {
+                node = node->hook.parent;
+            }
+            return node;
+        }
+
+        static size_t rank(const Node* node) noexcept {
+            size_t result = subtree(node->hook.left);
+            for (; node->hook.parent; node = node->hook.parent) {
+                const Node* parent = node->hook.parent;
+                if (parent->hook.right == node) {
+                    result += subtree(parent->hook.left) + parent->node_size;
+                }
+            }
+            return result;
+        }
+    };
+};
+
+struct ul_lazy_balance {
+    static constexpr size_t split_point(const size_t node_max_size) {
+        return node_max_size - 1;
+    }
+
+    static constexpr size_t merge_threshold(size_t) {
+        return 0;
+    }
+};
+
+struct ul_half_balance {
+    static constexpr size_t split_point(const size_t node_max_size) {
+        return node_max_size / 2;
+    }
+
+    static constexpr size_t merge_threshold(const size_t node_max_size) {
+        return node_max_size / 2;
+    }
+};
+
+#if defined(__cpp_lib_hardware_interference_size) && defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winterference-size"
+inline constexpr size_t ul_cache_line_size = std::hardware_destructive_interference_size;
+#pragma GCC diagnostic pop
+#elif defined(__cpp_lib_hardware_interference_size)
+inline constexpr size_t ul_cache_line_size = std::hardware_destructive_interference_size;
+#else
+inline constexpr size_t ul_cache_line_size = 64;
+#endif
+
+// Number of elements that fit into a node of Bytes bytes next to its header
+// (node_size, next, prev, offset and IndexPolicy's node hook), at least one.
+template<typename T, size_t Bytes, typename IndexPolicy = ul_no_index>
+inline constexpr size_t ul_node_size_for_bytes = [] {
+    using hook = typename IndexPolicy::template node_hook<void>;
+    constexpr size_t hook_size = std::is_empty_v<hook> ? 0 : sizeof(hook);
+    constexpr size_t header = 2 * sizeof(size_t) + 2 * sizeof(void*) + hook_size;
+    constexpr size_t payload_offset = (header + alignof(T) - 1) / alignof(T) * alignof(T);
+    return Bytes > payload_offset + sizeof(T) ? (Bytes - payload_offset) / sizeof(T) : size_t{1};
+}();
+
+// NodeMaxSize that makes one node span CacheLines cache lines, e.g.
+// unrolled_list<T, ul_auto_node_size<T>> or unrolled_list<T, ul_auto_node_size<T, 4>>.
+// Indexed lists pass their IndexPolicy too, since its hook lives in every node.
+template<typename T, size_t CacheLines = 1, typename IndexPolicy = ul_no_index>
+inline constexpr size_t ul_auto_node_size = ul_node_size_for_bytes<T, CacheLines * ul_cache_line_size, IndexPolicy>;
+
+// Allocators whose memory is reclaimed in bulk, like an arena. A list of trivially
+// destructible T using one drops its nodes in clear() and the destructor without
+// visiting them. Specialize for your own arena allocator; std::pmr lists detect a
+// std::pmr::monotonic_buffer_resource at run time.
+template<typename Allocator>
+struct ul_bulk_release : std::false_type {};
+
+// Tag of the range constructor: std::from_range_t where the library has it.
+#if defined(__cpp_lib_containers_ranges)
+using ul_from_range_t = std::from_range_t;
+inline constexpr ul_from_range_t ul_from_range = std::from_range;
+#else
+struct ul_from_range_t {
+    explicit ul_from_range_t() = default;
+};
+inline constexpr ul_from_range_t ul_from_range{};
+#endif
+
+/*
+    File format of unrolled_list::save/load and unrolled_list_view: a ul_file_header,
+    then one record per node, holding its node_size as std::uint64_t followed by its
+    elements as raw bytes. Records and element blocks start at multiples of
+    ul_file_alignment<T>. Fields are in the byte order of the writer; a file from a
+    machine of the other order fails the magic check.
+*/
+inline constexpr std::uint64_t ul_file_magic = 0x31'4C'4C'4F'52'4E'55;  // "UNROLL1"
+inline constexpr std::uint32_t ul_file_version = 1;
+inline constexpr size_t ul_file_buffer_size = size_t{1} << 20;
+
+template<typename T>
+inline constexpr size_t ul_file_alignment = std::max(alignof(std::uint64_t), alignof(T));
+
+constexpr size_t ul_file_round_up(const size_t bytes, const size_t alignment) noexcept {
+    return (bytes + alignment - 1) / alignment * alignment;
+}
+
+struct ul_file_header {
+    std::uint64_t magic = ul_file_magic;
+    std::uint32_t version = ul_file_version;
+    std::uint32_t element_size = 0;
+    std::uint32_t element_alignment = 0;
+    std::uint32_t reserved = 0;
+    std::uint64_t size = 0;
+    std::uint64_t node_count = 0;
+
+    template<typename T>
+    static ul_file_header describe(const size_t size, const size_t node_count) noexcept {
+        ul_file_header header;
+        header.element_size = sizeof(T);
+        header.element_alignment = alignof(T);
+        header.size = size;
+        header.node_count = node_count;
+        return header;
+    }
+
+    template<typename T>
+    bool holds() const noexcept {
+        return magic == ul_file_magic && version == ul_file_version
+            && element_size == sizeof(T) && element_alignment == alignof(T);
+    }
+};
 
-template<typename T, size_t NodeMaxSize = 10, typename t_allocator = std::allocator<T>>
+template<typename Range, typename T>
+concept ul_container_compatible_range =
+    std::ranges::input_range<Range> && std::convertible_to<std::ranges::range_reference_t<Range>, T>;
+
+template<typename T, size_t NodeMaxSize = 10, typename t_allocator = std::allocator<T>,
+         typename IndexPolicy = ul_no_index, typename BalancePolicy = ul_half_balance>
 class unrolled_list {
 
-struct Node {
+// Link part of a node. The list owns one NodeBase without storage as a sentinel:
+// the chain is circular through it, so end() is the sentinel and --end() is the tail.
+struct NodeBase {
         size_t node_size;
-        T* data;
-        Node *next;
-        Node *prev;
+        NodeBase *next;
+        NodeBase *prev;
 
-        Node() : node_size(0), data(nullptr), next(nullptr), prev(nullptr) {}
+        NodeBase() : node_size(0), next(this), prev(this) {}
 
-        Node(const size_t node_size, T *data, Node *next, Node *prev)
+        NodeBase(const size_t node_size, NodeBase *next, NodeBase *prev)
             : node_size(node_size)
-            , data(data)
             , next(next)
             , prev(prev) {
         }
 
-        Node(const Node &other)
-            : node_size(other.node_size)
-            , data(other.data)
-            , next(other.next)
-            , prev(other.prev) {
+        NodeBase(const NodeBase &other) = delete;
+        NodeBase& operator=(const NodeBase &other) = delete;
+    };
+
+// Elements occupy slots [offset, offset + node_size) of storage, so both ends
+// of a node can grow and shrink in place.
+struct Node : NodeBase {
+        size_t offset = 0;
+        [[no_unique_address]] typename IndexPolicy::template node_hook<Node> hook;
+        alignas(T) unsigned char storage[sizeof(T) * NodeMaxSize];
+
+        Node(const size_t node_size, NodeBase *next, NodeBase *prev)
+            : NodeBase(node_size, next, prev) {
+        }
+
+        T* slots() noexcept {
+            return reinterpret_cast<T*>(storage);
         }
 
-        Node& operator=(const Node &other) {
-            if (this == &other)
-                return *this;
-            node_size = other.node_size;
-            data = other.data;
-            next = other.next;
-            prev = other.prev;
-            return *this;
+        T* data() noexcept {
+            return std::launder(slots() + offset);
+        }
+
+        const T* data() const noexcept {
+            return std::launder(reinterpret_cast<const T*>(storage) + offset);
+        }
+
+        size_t back_room() const noexcept {
+            return NodeMaxSize - offset - this->node_size;
         }
     };
 
@@ -44,6 +367,9 @@ public:
     template<bool IsConst = false>
     struct ul_iterator;
 
+    template<bool IsConst = false>
+    struct ul_segment_iterator;
+
     using value_type = T;
     using reference = T&;
     using const_reference = const T&;
@@ -57,17 +383,36 @@ public:
     using t_allocator_traits = std::allocator_traits<t_allocator>;
     using node_allocator = typename t_allocator_traits::template rebind_alloc<Node>;
     using node_allocator_traits = std::allocator_traits<node_allocator>;
+    using index_tree = typename IndexPolicy::template tree<Node>;
+    using segment_iterator = ul_segment_iterator<>;
+    using const_segment_iterator = ul_segment_iterator<true>;
+
+    static constexpr size_t default_node_cache_limit = 2;
+
+    // Elements may be copied, moved and destroyed around the allocator when it has
+    // no construct/destroy of its own: as raw bytes for trivially copyable T.
+    // polymorphic_allocator only adds uses-allocator construction to the plain one.
+    static constexpr bool polymorphic_allocator = std::is_same_v<t_allocator, std::pmr::polymorphic_allocator<T>>;
+    static constexpr bool allocator_constructs =
+        requires(t_allocator& alloc, T* place, const T& value) { alloc.construct(place, value); }
+        && !(polymorphic_allocator && !std::uses_allocator_v<T, t_allocator>);
+    static constexpr bool allocator_destroys =
+        requires(t_allocator& alloc, T* place) { alloc.destroy(place); } && !polymorphic_allocator;
+    static constexpr bool trivially_destroyed = std::is_trivially_destructible_v<T> && !allocator_destroys;
+    static constexpr bool bitwise_copyable =
+        std::is_trivially_copyable_v<T> && !allocator_constructs && !allocator_destroys;
 
 
 private:
 
-    Node sentinel_;
-    Node* tail_;
-    Node* head_;
+    NodeBase sentinel_;
     size_t size_{};
-    bool is_empty_ = false;
     allocator_type t_alloc_;
     node_allocator node_alloc_;
+    Node* free_nodes_ = nullptr;
+    size_t free_count_ = 0;
+    size_t node_cache_limit_ = default_node_cache_limit;
+    [[no_unique_address]] index_tree index_;
 
 public:
 
@@ -77,7 +422,8 @@ public:
         using value_type = T;
         using difference_type = std::ptrdiff_t;
         using ref = T&;
-        using node_ptr = std::conditional_t<IsConst, const Node*, Node*>;
+        using node_ptr = std::conditional_t<IsConst, const NodeBase*, NodeBase*>;
+        using value_node_ptr = std::conditional_t<IsConst, const Node*, Node*>;
         using reference = std::conditional_t<IsConst, const T&, T&>;
         using pointer = std::conditional_t<IsConst, const T*, T*>;
         using iterator_category = std::bidirectional_iterator_tag;
@@ -98,6 +444,11 @@ public:
         }
         ul_iterator(node_ptr node, const size_t index) : current_node(node), current_index(index) {
         }
+        template<bool OtherConst, typename = std::enable_if_t<IsConst && !OtherConst>>
+        ul_iterator(const ul_iterator<OtherConst> &other)
+            : current_node(other.current_node)
+              , current_index(other.current_index) {
+        }
         ul_iterator &operator=(const ul_iterator &other) = default;
 
         friend void swap(ul_iterator &it1, ul_iterator &it2) noexcept {
@@ -114,11 +465,11 @@ public:
         }
 
         reference operator*() const {
-            return current_node->data[current_index];
+            return static_cast<value_node_ptr>(current_node)->data()[current_index];
         }
 
         pointer operator->() const {
-            return &(current_node->data[current_index]);
+            return &(static_cast<value_node_ptr>(current_node)->data()[current_index]);
         }
 
         ul_iterator& operator++() {
@@ -132,6 +483,11 @@ public:
         }
 
         ul_iterator operator+(size_t count) const {
+            if constexpr (IndexPolicy::indexed) {
+                if (count != 0 && count >= current_node->node_size - current_index) {
+                    return jump(absolute_index() + count);
+                }
+            }
             ul_iterator it = *this;
 
             while (count > 0) {
@@ -149,25 +505,46 @@ public:
         }
 
         ul_iterator operator-(size_t count) const {
-            ul_iterator it = *this;
-
-            while (count > 0) {
-                if (it.current_index >= count) {
-                    it.current_index -= count;
-                    return it;
-                }
-                if (it.current_node->prev == nullptr) {
-                    return it;
+            if constexpr (IndexPolicy::indexed) {
+                if (count > current_index) {
+                    const size_t position = absolute_index();
+                    return jump(count > position ? 0 : position - count);
                 }
+            }
+            ul_iterator it = *this;
 
-                count -= (it.current_index + 1);
+            while (count > it.current_index) {
+                count -= it.current_index + 1;
                 it.current_node = it.current_node->prev;
                 it.current_index = it.current_node->node_size - 1;
             }
+            it.current_index -= count;
 
             return it;
         }
 
+        // Indexed lists only. The sentinel is the one linked node without elements,
+        // so an iterator on an empty node is end() and the tree is reached through the tail.
+        Node* tree_root() const {
+            const NodeBase* node = current_node->node_size == 0 ? current_node->prev : current_node;
+            return index_tree::root_of(const_cast<Node*>(static_cast<const Node*>(node)));
+        }
+
+        size_t absolute_index() const {
+            if (current_node->node_size == 0) {
+                return index_tree::subtree(tree_root());
+            }
+            return index_tree::rank(static_cast<const Node*>(current_node)) + current_index;
+        }
+
+        ul_iterator jump(size_t position) const {
+            Node* root = tree_root();
+            if (Node* node = index_tree::find(root, position)) {
+                return ul_iterator(node, position);
+            }
+            return ul_iterator(index_tree::last(root)->next, 0);
+        }
+
         ul_iterator operator++(int) {
             ul_iterator temp = *this;
             ++(*this);
@@ -180,7 +557,7 @@ public:
                 return *this;
             }
             current_node = current_node->prev;
-            current_index = NodeMaxSize - 1;
+            current_index = current_node->node_size - 1;
             return *this;
         }
 
@@ -191,397 +568,1023 @@ public:
             return temp;
         }
 
+        // Segmented iterator protocol used by the ul_* algorithms: calls
+        // visit(pointer from, pointer to) for each contiguous run of [first, last)
+        // and stops at the first run where visit returns something other than to.
+        static constexpr bool is_segmented = true;
+
+        template<typename Visitor>
+        static ul_iterator visit_segments(ul_iterator first, const ul_iterator last, Visitor&& visit) {
+            node_ptr node = first.current_node;
+            size_t from = first.current_index;
+            while (true) {
+                const size_t to = node == last.current_node ? last.current_index : node->node_size;
+                if (from != to) {
+                    pointer data = static_cast<value_node_ptr>(node)->data();
+                    pointer stop = visit(data + from, data + to);
+                    if (stop != data + to) {
+                        return ul_iterator(node, stop - data);
+                    }
+                }
+                if (node == last.current_node) {
+                    return last;
+                }
+                node = node->next;
+                from = 0;
+            }
+        }
+
         ~ul_iterator() = default;
     };
 
-    unrolled_list() : sentinel_(), tail_(nullptr), head_(nullptr), size_(0), is_empty_(true) {
-    }
-    explicit unrolled_list(const allocator_type& alloc)
-    : tail_(nullptr), head_(nullptr), size_(0), is_empty_(true), t_alloc_(alloc), node_alloc_(alloc) {}
+    // Walks the list node by node; each node is one contiguous std::span.
+    template<bool IsConst>
+    struct ul_segment_iterator {
 
-    unrolled_list(const unrolled_list &other) {
-        for (auto& i : other) {
-            push_back(i);
+        using value_type = std::span<std::conditional_t<IsConst, const T, T>>;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::bidirectional_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using node_ptr = std::conditional_t<IsConst, const NodeBase*, NodeBase*>;
+        using value_node_ptr = std::conditional_t<IsConst, const Node*, Node*>;
+
+        node_ptr current_node = nullptr;
+
+        ul_segment_iterator() = default;
+        explicit ul_segment_iterator(node_ptr node) : current_node(node) {}
+
+        value_type operator*() const {
+            return value_type(static_cast<value_node_ptr>(current_node)->data(), current_node->node_size);
         }
-    }
 
-    unrolled_list(const unrolled_list& other, const allocator_type& alloc)
-    : tail_(nullptr), head_(nullptr), size_(0), is_empty_(true), t_alloc_(alloc), node_alloc_(alloc) {
-        for (const auto& elem : other) {
-            push_back(elem);
+        ul_segment_iterator& operator++() {
+            current_node = current_node->next;
+            return *this;
         }
-    }
-    unrolled_list(const size_t count, const T& value) {
-        if (count == 0) {
-            sentinel_ = Node();
-            is_empty_ = true;
-            head_ = nullptr;
-            tail_ = nullptr;
-            size_ = 0;
 
-            return;
+        ul_segment_iterator operator++(int) {
+            ul_segment_iterator temp = *this;
+            ++(*this);
+            return temp;
+        }
+
+        ul_segment_iterator& operator--() {
+            current_node = current_node->prev;
+            return *this;
         }
-        const size_t rem = count % NodeMaxSize;
-        size_t node_count = count / NodeMaxSize;
-        size_t ul_size = node_count * NodeMaxSize;
 
-        if (rem) {
-            ++node_count;
-            ul_size += rem;
+        ul_segment_iterator operator--(int) {
+            ul_segment_iterator temp = *this;
+            --(*this);
+            return temp;
         }
 
-        size_ = ul_size;
+        bool operator==(const ul_segment_iterator& other) const = default;
+    };
 
-        Node* prev_node = nullptr;
+    unrolled_list() : sentinel_(), size_(0) {
+    }
+    explicit unrolled_list(const allocator_type& alloc)
+    : size_(0), t_alloc_(alloc), node_alloc_(alloc) {}
 
-        for (size_t i = 0; i < node_count; ++i) {
-            Node* new_node = node_allocator_traits::allocate(node_alloc_, 1);
-            node_allocator_traits::construct(node_alloc_, new_node, 0, nullptr, nullptr, prev_node);
-            new_node->data = t_allocator_traits::allocate(t_alloc_, NodeMaxSize);
+    unrolled_list(const unrolled_list &other)
+    : unrolled_list(other, t_allocator_traits::select_on_container_copy_construction(other.t_alloc_)) {
+    }
 
-            if (i == 0) {
-                head_ = new_node;
+    // Clones other node by node, keeping its per-node fill.
+    unrolled_list(const unrolled_list& other, const allocator_type& alloc)
+    : t_alloc_(alloc), node_alloc_(alloc), node_cache_limit_(other.node_cache_limit_) {
+        if (!other.empty()) {
+            try {
+                link_chain_after(&sentinel_, clone_chain(other.sentinel_.next, &other.sentinel_));
+            } catch (...) {
+                release_node_cache();
+                throw;
             }
+        }
+    }
 
-            if (i == node_count - 1 && rem != 0) {
-                for (size_t j = 0; j < rem; j++) {
-                    t_allocator_traits::construct(t_alloc_, new_node->data + j, value);
-                    ++new_node->node_size;
-                }
-                prev_node->next = new_node;
-                tail_ = new_node;
+    unrolled_list(unrolled_list&& other) noexcept
+    : t_alloc_(std::move(other.t_alloc_)), node_alloc_(std::move(other.node_alloc_))
+    , free_nodes_(other.free_nodes_), free_count_(other.free_count_), node_cache_limit_(other.node_cache_limit_) {
+        take_nodes(other);
+        other.free_nodes_ = nullptr;
+        other.free_count_ = 0;
+    }
 
+    unrolled_list(unrolled_list&& other, const allocator_type& alloc)
+    : t_alloc_(alloc), node_alloc_(alloc) {
+        if constexpr (t_allocator_traits::is_always_equal::value) {
+            take_nodes(other);
+        } else {
+            if (t_alloc_ == other.t_alloc_) {
+                take_nodes(other);
                 return;
             }
-            for (size_t j = 0; j < NodeMaxSize; j++) {
-                t_allocator_traits::construct(t_alloc_, new_node->data + j, value);
-                ++new_node->node_size;
-
+            try {
+                for (auto& elem : other) {
+                    emplace_back(std::move(elem));
+                }
+            } catch (...) {
+                clear();
+                release_node_cache();
+                throw;
             }
+            other.clear();
+        }
+    }
 
-            if (i == node_count - 1) {
-                tail_ = new_node;
-            }
+    unrolled_list(const size_t count, const T& value, const allocator_type& alloc = allocator_type())
+    : t_alloc_(alloc), node_alloc_(alloc) {
+        try {
+            append_copies(count, value);
+        } catch (...) {
+            release_node_cache();
+            throw;
+        }
+    }
 
-            if (prev_node) {
-                prev_node->next = new_node;
-            }
-            prev_node = new_node;
+    explicit unrolled_list(const size_t count, const allocator_type& alloc = allocator_type())
+    : t_alloc_(alloc), node_alloc_(alloc) {
+        try {
+            append_copies(count);
+        } catch (...) {
+            release_node_cache();
+            throw;
         }
     }
 
     template<typename InputIterator, typename = std::enable_if_t<!std::is_integral_v<InputIterator>>>
-    unrolled_list(InputIterator first, InputIterator last) {
+    unrolled_list(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type())
+    : t_alloc_(alloc), node_alloc_(alloc) {
+        try {
+            append_from(first, last, count_of(first, last));
+        } catch (...) {
+            release_node_cache();
+            throw;
+        }
+    }
 
-        if (first == last) {
-            is_empty_ = true;
-            head_ = nullptr;
-            tail_ = nullptr;
-            size_ = 0;
+    template<ul_container_compatible_range<T> Range>
+    unrolled_list(ul_from_range_t, Range&& range, const allocator_type& alloc = allocator_type())
+    : t_alloc_(alloc), node_alloc_(alloc) {
+        try {
+            append_range(std::forward<Range>(range));
+        } catch (...) {
+            release_node_cache();
+            throw;
+        }
+    }
 
+    unrolled_list(std::initializer_list<T> list, const allocator_type& alloc = allocator_type())
+    : unrolled_list(list.begin(), list.end(), alloc) {}
+
+    ~unrolled_list() {
+        if (releases_in_bulk()) {
             return;
         }
-        is_empty_ = false;
-
-        size_t ul_size = 0;
-        Node* prev_node = nullptr;
-        bool is_first_it = true;
-        while (first != last) {
-            Node* new_node = node_allocator_traits::allocate(node_alloc_, 1);
-            node_allocator_traits::construct(node_alloc_, new_node, 0, nullptr, nullptr, prev_node);
+        clear();
+        release_node_cache();
+    }
 
-            if (is_first_it) {
-                head_ = new_node;
-                is_first_it = false;
-            }
+    // Arena mode: nodes need neither element destruction nor deallocation one by one.
+    bool releases_in_bulk() const noexcept {
+        if constexpr (!trivially_destroyed) {
+            return false;
+        } else if constexpr (ul_bulk_release<t_allocator>::value) {
+            return true;
+        } else if constexpr (polymorphic_allocator) {
+            return dynamic_cast<std::pmr::monotonic_buffer_resource*>(t_alloc_.resource()) != nullptr;
+        } else {
+            return false;
+        }
+    }
 
-            new_node->data = t_allocator_traits::allocate(t_alloc_, NodeMaxSize);
-            for (int i = 0; i < NodeMaxSize; ++i) {
-                t_allocator_traits::construct(t_alloc_, new_node->data + i, *first);
-                ++ul_size;
-                ++new_node->node_size;
-                ++first;
-                if (first == last) {
-                    if (prev_node) {
-                        prev_node->next = new_node;
-                    }
-                    tail_ = new_node;
-                    break;
+    unrolled_list &operator=(const unrolled_list &other) {
+        if (this != &other) {
+            if constexpr (t_allocator_traits::propagate_on_container_copy_assignment::value) {
+                if (t_alloc_ != other.t_alloc_) {
+                    clear();
+                    release_node_cache();
                 }
+                t_alloc_ = other.t_alloc_;
+                node_alloc_ = other.node_alloc_;
+            }
+            assign_nodes(other);
+        }
+        return *this;
+    }
 
+    unrolled_list &operator=(unrolled_list &&other) noexcept(
+        t_allocator_traits::propagate_on_container_move_assignment::value
+        || t_allocator_traits::is_always_equal::value) {
+        if (this == &other) {
+            return *this;
+        }
+        clear();
+        if constexpr (t_allocator_traits::propagate_on_container_move_assignment::value) {
+            release_node_cache();
+            t_alloc_ = std::move(other.t_alloc_);
+            node_alloc_ = std::move(other.node_alloc_);
+            take_nodes(other);
+        } else if constexpr (t_allocator_traits::is_always_equal::value) {
+            take_nodes(other);
+        } else {
+            if (t_alloc_ == other.t_alloc_) {
+                take_nodes(other);
+                return *this;
             }
-            if (prev_node) {
-                prev_node->next = new_node;
+            for (auto& elem : other) {
+                emplace_back(std::move(elem));
             }
-            prev_node = new_node;
+            other.clear();
         }
+        return *this;
+    }
 
+    Node* allocate_node() {
+        if (free_nodes_ != nullptr) {
+            Node* node = free_nodes_;
+            free_nodes_ = static_cast<Node*>(node->next);
+            --free_count_;
+            destroy_node(node);
+            return node;
+        }
+        return node_allocator_traits::allocate(node_alloc_, 1);
+    }
 
-        size_ = ul_size;
+    void recycle_node(Node* place) noexcept {
+        if (free_count_ < node_cache_limit_) {
+            construct_node(place, 0, free_nodes_, nullptr);
+            free_nodes_ = place;
+            ++free_count_;
+            return;
+        }
+        node_allocator_traits::deallocate(node_alloc_, place, 1);
     }
 
-   template<typename InputIterator, typename = std::enable_if_t<!std::is_integral_v<InputIterator>>>
-unrolled_list(InputIterator first, InputIterator last, const allocator_type alloc) : t_alloc_(alloc) {
-    if (first == last) {
-        is_empty_ = true;
-        head_ = nullptr;
-        tail_ = nullptr;
-        size_ = 0;
-        return;
+    void trim_node_cache(const size_t keep) noexcept {
+        while (free_count_ > keep) {
+            Node* node = free_nodes_;
+            free_nodes_ = static_cast<Node*>(node->next);
+            --free_count_;
+            destroy_node(node);
+            node_allocator_traits::deallocate(node_alloc_, node, 1);
+        }
     }
 
-    is_empty_ = false;
+    void release_node_cache() noexcept {
+        trim_node_cache(0);
+    }
 
-    std::vector<Node*> allocated_nodes;
-    size_t ul_size = 0;
-    Node* prev_node = nullptr;
-    bool is_first_it = true;
-    size_t sucussfull_construct = 0;
+    void construct_node(Node* place, const size_t& node_size, NodeBase* next, NodeBase* prev) {
+        node_allocator_traits::construct(node_alloc_, place, node_size, next, prev);
+    }
 
-    try {
+    template<typename... Args>
+    void construct_t(T* place, Args&&... args) {
+        t_allocator_traits::construct(t_alloc_, place, std::forward<Args>(args)...);
+    }
 
-        while (first != last) {
-            Node* new_node = node_allocator_traits::allocate(node_alloc_, 1);
-            allocated_nodes.push_back(new_node);
-            node_allocator_traits::construct(node_alloc_, new_node, 0, nullptr, nullptr, prev_node);
+    void destroy_t(T* place) {
+        t_allocator_traits::destroy(t_alloc_, place);
+    }
 
-            if (is_first_it) {
-                head_ = new_node;
-                is_first_it = false;
+    void destroy_range(T* first, const size_t count) noexcept {
+        if constexpr (!trivially_destroyed) {
+            for (size_t i = 0; i < count; ++i) {
+                destroy_t(first + i);
             }
+        }
+    }
 
-            new_node->data = t_allocator_traits::allocate(t_alloc_, NodeMaxSize);
-
+    // memmove of count elements; only for bitwise_copyable T.
+    static void move_bits(T* target, const T* source, const size_t count) noexcept {
+        if (count != 0) {
+            std::memmove(static_cast<void*>(target), source, count * sizeof(T));
+        }
+    }
 
-            for (int i = 0; i < NodeMaxSize; ++i) {
-                t_allocator_traits::construct(t_alloc_, new_node->data + i, *first);
-                sucussfull_construct++;
-                ++ul_size;
-                ++new_node->node_size;
-                ++first;
-                if (first == last) {
-                    if (prev_node) {
-                        prev_node->next = new_node;
-                    }
-                    tail_ = new_node;
-                    break;
-                }
+    // Moves count elements from source into the raw slots at target and destroys the
+    // originals. The ranges may overlap. Only used for nothrow-movable types.
+    void relocate(T* target, T* source, const size_t count) noexcept {
+        if constexpr (bitwise_copyable) {
+            move_bits(target, source, count);
+        } else if (target < source) {
+            for (size_t i = 0; i < count; ++i) {
+                construct_t(target + i, std::move(source[i]));
+                destroy_t(source + i);
             }
-
-
-            if (prev_node) {
-                prev_node->next = new_node;
+        } else if (target > source) {
+            for (size_t i = count; i-- > 0;) {
+                construct_t(target + i, std::move(source[i]));
+                destroy_t(source + i);
             }
-
-            prev_node = new_node;
         }
+    }
 
+    void destroy_node(Node* place) {
+        node_allocator_traits::destroy(node_alloc_, place);
+    }
 
-        size_ = ul_size;
-
-    } catch (...) {
-        const size_t full_destroyed_nodes = sucussfull_construct / NodeMaxSize;
-        const size_t rem = sucussfull_construct % NodeMaxSize;
-        size_t it = 0;
-        while (it != full_destroyed_nodes) {
-            Node* node = allocated_nodes[it];
-            for (int i = 0; i < NodeMaxSize; ++i) {
-                t_allocator_traits::destroy(t_alloc_, node->data + i);
-            }
-            t_allocator_traits::deallocate(t_alloc_, node->data, NodeMaxSize);
+    void delete_node(Node* current_node) {
+        destroy_range(current_node->data(), current_node->node_size);
+        destroy_node(current_node);
+        recycle_node(current_node);
+    }
 
-            node_allocator_traits::destroy(node_alloc_, node);
-            node_allocator_traits::deallocate(node_alloc_, node, 1);
-            ++it;
-        }
-        if (rem != 0) {
-            Node* node = allocated_nodes[it];
-            for (int i = 0; i < rem; ++i) {
-                t_allocator_traits::destroy(t_alloc_, node->data + i);
-            }
-            t_allocator_traits::deallocate(t_alloc_, node->data, NodeMaxSize);
 
-            node_allocator_traits::destroy(node_alloc_, node);
-            node_allocator_traits::deallocate(node_alloc_, node, 1);
-        }
-        throw;
+    static Node* as_node(NodeBase* node) noexcept {
+        return static_cast<Node*>(node);
     }
-}
-
 
+    static Node* node_of(const_iterator position) noexcept {
+        return as_node(const_cast<NodeBase*>(position.current_node));
+    }
 
+    Node* head_node() noexcept {
+        return as_node(sentinel_.next);
+    }
 
+    Node* tail_node() noexcept {
+        return as_node(sentinel_.prev);
+    }
 
-    unrolled_list(std::initializer_list<T> list) : unrolled_list(list.begin(), list.end()) {}
+    const Node* tail_node() const noexcept {
+        return static_cast<const Node*>(sentinel_.prev);
+    }
 
-    ~unrolled_list() {
-        Node* current_node = head_;
-        while (current_node) {
-            Node* temp = current_node->next;
-            for (int i = 0; i < current_node->node_size; ++i) {
-                t_allocator_traits::destroy(t_alloc_, current_node->data + i);
-            }
-            t_allocator_traits::deallocate(t_alloc_, current_node->data, NodeMaxSize);
-            node_allocator_traits::destroy(node_alloc_, current_node);
-            node_allocator_traits::deallocate(node_alloc_, current_node, 1);
-            current_node = temp;
-        }
+    void index_link(Node* node) noexcept {
+        index_.on_link(node, node->prev == &sentinel_ ? nullptr : as_node(node->prev));
     }
 
-    unrolled_list &operator=(const unrolled_list &other) {
-        if (this != &other) {
-            t_alloc_ = other.t_alloc_;
-            node_alloc_ = other.node_alloc_;
-            unrolled_list temp(other.cbegin(), other.cend());
-            swap(temp);
+    // Moves the node chain hanging off sentinel from over to sentinel to.
+    static void relink_sentinel(NodeBase& to, NodeBase& from) noexcept {
+        if (from.next == &from) {
+            to.next = to.prev = &to;
+            return;
         }
-        return *this;
+        to.next = from.next;
+        to.prev = from.prev;
+        to.next->prev = &to;
+        to.prev->next = &to;
+        from.next = from.prev = &from;
     }
 
-    Node* allocate_node() {
-        return node_allocator_traits::allocate(node_alloc_, 1);
-    }
+    Node* create_node_after(NodeBase* current_node, const size_t size) {
+        Node* new_node = allocate_node();
+        construct_node(new_node, size, current_node->next, current_node);
+        current_node->next->prev = new_node;
+        current_node->next = new_node;
+        index_link(new_node);
 
-    T* allocate_t() {
-        return t_allocator_traits::allocate(t_alloc_, NodeMaxSize);
+        return new_node;
     }
 
-    void construct_node(Node* place, const size_t& node_size, T* data, Node* next, Node* prev) {
-        node_allocator_traits::construct(node_alloc_, place, node_size, data, next, prev);
+    // Shifts the elements of node to start at slot offset. Only used for nothrow-movable types.
+    void realign(Node* node, const size_t offset) noexcept {
+        relocate(node->slots() + offset, node->data(), node->node_size);
+        node->offset = offset;
     }
 
-    void construct_t(T* place, const T& value) {
-        t_allocator_traits::construct(t_alloc_, place, value);
+    // A node at most half full is worth realigning instead of allocating a neighbour:
+    // the shift costs at most NodeMaxSize / 2 moves and frees at least as many slots.
+    static bool worth_realigning(const Node* node) noexcept {
+        return std::is_nothrow_move_constructible_v<T> && node->node_size <= NodeMaxSize / 2;
     }
 
-    void destroy_t(T* place) {
-        t_allocator_traits::destroy(t_alloc_, place);
+    Node* back_node_with_room() {
+        if (size_ != 0) {
+            Node* tail = tail_node();
+            if (tail->back_room() != 0) {
+                return tail;
+            }
+            if (worth_realigning(tail)) {
+                realign(tail, 0);
+                return tail;
+            }
+        }
+        return create_node_after(sentinel_.prev, 0);
     }
 
-    void destroy_node(Node* place) {
-        node_allocator_traits::destroy(node_alloc_, place);
+    struct node_chain {
+        Node* first = nullptr;
+        Node* last = nullptr;
+        size_t size = 0;
+    };
+
+    // The element is constructed before a fresh node is linked, so a throwing
+    // constructor never leaves an empty node in the chain.
+    template<typename... Args>
+    void chain_emplace_back(node_chain& chain, Args&&... args) {
+        if (chain.last == nullptr || chain.last->back_room() == 0) {
+            Node* new_node = allocate_node();
+            construct_node(new_node, 0, nullptr, chain.last);
+            try {
+                construct_t(new_node->data(), std::forward<Args>(args)...);
+            } catch (...) {
+                delete_node(new_node);
+                throw;
+            }
+            new_node->node_size = 1;
+            ++chain.size;
+            if (chain.last) {
+                chain.last->next = new_node;
+            } else {
+                chain.first = new_node;
+            }
+            chain.last = new_node;
+            return;
+        }
+        construct_t(chain.last->data() + chain.last->node_size, std::forward<Args>(args)...);
+        ++chain.last->node_size;
+        ++chain.size;
     }
 
-    void delete_node(Node* current_node) {
-        for (int i = 0; i < NodeMaxSize; ++i) {
-            t_allocator_traits::destroy(t_alloc_, current_node->data + i);
+    Node* chain_pop_node(node_chain& chain) noexcept {
+        Node* node = chain.first;
+        chain.first = as_node(node->next);
+        if (chain.first == nullptr) {
+            chain.last = nullptr;
+        } else {
+            chain.first->prev = nullptr;
         }
-        t_allocator_traits::deallocate(t_alloc_, current_node->data, NodeMaxSize);
-        node_allocator_traits::destroy(node_alloc_, current_node);
-        node_allocator_traits::deallocate(node_alloc_, current_node, 1);
+        chain.size -= node->node_size;
+        node->next = nullptr;
+        return node;
     }
 
+    void chain_push_node(node_chain& chain, Node* node) noexcept {
+        node->prev = chain.last;
+        node->next = nullptr;
+        if (chain.last) {
+            chain.last->next = node;
+        } else {
+            chain.first = node;
+        }
+        chain.last = node;
+        chain.size += node->node_size;
+    }
 
-    Node* create_node_after(Node* current_node, const size_t size) {
-        Node* prev_next = current_node->next;
-        current_node->next = allocate_node();
-        if (prev_next) {
-            prev_next->prev = current_node->next;
+    void chain_append(node_chain& chain, node_chain& rest) noexcept {
+        if (rest.first == nullptr) {
+            return;
+        }
+        if (chain.last) {
+            chain.last->next = rest.first;
+            rest.first->prev = chain.last;
+        } else {
+            chain.first = rest.first;
         }
-        construct_node(current_node->next, size, nullptr, prev_next, current_node);
-        Node* new_node = current_node->next;
-        new_node->data = allocate_t();
+        chain.last = rest.last;
+        chain.size += rest.size;
+        rest = {};
+    }
 
-        if (tail_ == current_node) {
-            tail_ = new_node;
+    void chain_destroy_front(node_chain& chain) noexcept {
+        Node* node = chain.first;
+        destroy_t(node->data());
+        ++node->offset;
+        --node->node_size;
+        --chain.size;
+        if (node->node_size == 0) {
+            delete_node(chain_pop_node(chain));
         }
+    }
 
-        return new_node;
+    /*
+        Stable merge of the sorted chains left and right into out, consuming both.
+        A node that entirely precedes the other side's head is relinked as is;
+        otherwise elements are moved one at a time. If compare or a copy throws,
+        every element is still in exactly one of the three chains.
+    */
+    template<typename Compare>
+    void merge_chains(node_chain& left, node_chain& right, node_chain& out, Compare& compare) {
+        while (left.first && right.first) {
+            Node* left_node = left.first;
+            Node* right_node = right.first;
+            if (out.last == nullptr || out.last->back_room() == 0) {
+                if (!compare(right_node->data()[0], left_node->data()[left_node->node_size - 1])) {
+                    chain_push_node(out, chain_pop_node(left));
+                    continue;
+                }
+                if (compare(right_node->data()[right_node->node_size - 1], left_node->data()[0])) {
+                    chain_push_node(out, chain_pop_node(right));
+                    continue;
+                }
+            }
+            node_chain& from = compare(right_node->data()[0], left_node->data()[0]) ? right : left;
+            chain_emplace_back(out, std::move_if_noexcept(from.first->data()[0]));
+            chain_destroy_front(from);
+        }
+        chain_append(out, left);
+        chain_append(out, right);
     }
 
+    void free_chain(Node* current_node) noexcept {
+        while (current_node) {
+            Node* next_node = as_node(current_node->next);
+            delete_node(current_node);
+            current_node = next_node;
+        }
+    }
 
-    void push_back(const T& value) {
-        Node* allocated_node = nullptr;
-        Node* prev_tail = tail_;
+    // Copy-constructs count elements into raw slots; on exception nothing is left constructed.
+    void copy_block(T* target, const T* source, const size_t count) {
+        if constexpr (bitwise_copyable) {
+            if (count != 0) {
+                std::memcpy(static_cast<void*>(target), source, count * sizeof(T));
+            }
+        } else if constexpr (!allocator_constructs) {
+            std::uninitialized_copy(source, source + count, target);
+        } else {
+            size_t i = 0;
+            try {
+                for (; i < count; ++i) {
+                    construct_t(target + i, source[i]);
+                }
+            } catch (...) {
+                while (i-- > 0) {
+                    destroy_t(target + i);
+                }
+                throw;
+            }
+        }
+    }
+
+    // Copies the nodes [first, last) of another list into a detached chain with the same fill.
+    node_chain clone_chain(const NodeBase* first, const NodeBase* last) {
+        node_chain chain;
         try {
-            ++size_;
-            if (tail_ == nullptr && head_ == nullptr) {
-                Node* new_node = allocate_node();
-                allocated_node = new_node;
-                construct_node(new_node, 1, nullptr, nullptr, nullptr);
-                new_node->data = allocate_t();
-                construct_t(new_node->data, value);
-                tail_ = new_node;
-                head_ = new_node;
-                is_empty_ = false;
-                return;
+            for (; first != last; first = first->next) {
+                const Node* source = static_cast<const Node*>(first);
+                Node* node = allocate_node();
+                construct_node(node, 0, nullptr, chain.last);
+                if (chain.last) {
+                    chain.last->next = node;
+                } else {
+                    chain.first = node;
+                }
+                chain.last = node;
+                copy_block(node->slots(), source->data(), source->node_size);
+                node->node_size = source->node_size;
+                chain.size += source->node_size;
             }
-            if (tail_->node_size != NodeMaxSize) {
-                construct_t(tail_->data + tail_->node_size, value);
-                ++tail_->node_size;
-                return;
+        } catch (...) {
+            free_chain(chain.first);
+            throw;
+        }
+        return chain;
+    }
+
+    // Overwrites the elements of node with those of source, reusing the node's storage.
+    void copy_into_node(Node* node, const Node* source) {
+        const size_t count = source->node_size;
+        size_ -= node->node_size;
+        if constexpr (bitwise_copyable) {
+            node->offset = 0;
+            std::memcpy(static_cast<void*>(node->slots()), source->data(), count * sizeof(T));
+            node->node_size = count;
+        } else {
+            if (node->offset + count > NodeMaxSize) {
+                while (node->node_size != 0) {
+                    destroy_t(node->data() + --node->node_size);
+                }
+                node->offset = 0;
+            }
+            T* data = node->data();
+            const T* from = source->data();
+            std::copy(from, from + std::min(node->node_size, count), data);
+            while (node->node_size > count) {
+                destroy_t(data + --node->node_size);
+            }
+            for (; node->node_size < count; ++node->node_size) {
+                construct_t(data + node->node_size, from[node->node_size]);
+            }
+        }
+        size_ += count;
+        index_.on_resize(node);
+    }
+
+    /*
+        Makes this list an element-wise copy of other, node for node: the existing nodes are
+        overwritten in place, and only the difference in node count is allocated or freed.
+        If a copy throws, the list is cleared.
+    */
+    void assign_nodes(const unrolled_list& other) {
+        NodeBase* target = sentinel_.next;
+        const NodeBase* source = other.sentinel_.next;
+        try {
+            for (; target != &sentinel_ && source != &other.sentinel_; target = target->next, source = source->next) {
+                copy_into_node(as_node(target), static_cast<const Node*>(source));
+            }
+            if (target != &sentinel_) {
+                free_chain(unlink_chain(target, &sentinel_).first);
+            } else if (source != &other.sentinel_) {
+                node_chain chain = clone_chain(source, &other.sentinel_);
+                link_chain_after(sentinel_.prev, chain);
             }
-            Node* new_node = create_node_after(tail_, 1);
-            construct_t(new_node->data,value);
         } catch (...) {
-            if (allocated_node) {
-                allocated_node->prev->next = nullptr;
-                delete_node(allocated_node);
+            clear();
+            throw;
+        }
+    }
+
+    void link_chain_after(NodeBase* prev_node, const node_chain& chain) noexcept {
+        NodeBase* next_node = prev_node->next;
+        chain.first->prev = prev_node;
+        chain.last->next = next_node;
+        prev_node->next = chain.first;
+        next_node->prev = chain.last;
+        for (NodeBase* node = chain.first; node != next_node; node = node->next) {
+            index_link(as_node(node));
+        }
+        size_ += chain.size;
+    }
+
+    // Writes count bytes and zeros up to the next multiple of ul_file_alignment<T>.
+    static void write_padded(std::ostream& out, const void* bytes, const size_t count) {
+        static constexpr char zeros[ul_file_alignment<T>] = {};
+        out.write(static_cast<const char*>(bytes), static_cast<std::streamsize>(count));
+        out.write(zeros, static_cast<std::streamsize>(ul_file_round_up(count, ul_file_alignment<T>) - count));
+    }
+
+    static void read_padded(std::istream& in, void* bytes, const size_t count) {
+        in.read(static_cast<char*>(bytes), static_cast<std::streamsize>(count));
+        in.ignore(static_cast<std::streamsize>(ul_file_round_up(count, ul_file_alignment<T>) - count));
+    }
+
+    static constexpr size_t unknown_count = static_cast<size_t>(-1);
+
+    // Length of [first, last) if it can be had without consuming the elements.
+    template<typename Iterator, typename Sentinel>
+    static size_t count_of(const Iterator& first, const Sentinel& last) {
+        if constexpr (std::sized_sentinel_for<Sentinel, Iterator> || std::forward_iterator<Iterator>) {
+            return static_cast<size_t>(std::ranges::distance(first, last));
+        } else {
+            return unknown_count;
+        }
+    }
+
+    // begin() of an input-only range may consume an element, so it is not called here.
+    template<typename Range>
+    static size_t count_of_range(Range& range) {
+        if constexpr (std::ranges::sized_range<Range>) {
+            return static_cast<size_t>(std::ranges::size(range));
+        } else if constexpr (std::ranges::forward_range<Range>) {
+            return static_cast<size_t>(std::ranges::distance(range));
+        } else {
+            return unknown_count;
+        }
+    }
+
+    // Constructs count elements into raw slots from source and returns the advanced
+    // iterator; on exception nothing is left constructed.
+    template<typename Iterator>
+    Iterator fill_block(T* target, Iterator source, const size_t count) {
+        if constexpr (bitwise_copyable && std::contiguous_iterator<Iterator>
+                      && std::is_same_v<std::iter_value_t<Iterator>, T>) {
+            if (count != 0) {
+                std::memcpy(static_cast<void*>(target), std::to_address(source), count * sizeof(T));
             }
-            tail_ = prev_tail;
+            return source + count;
+        } else {
+            size_t i = 0;
+            try {
+                for (; i < count; ++i, ++source) {
+                    construct_t(target + i, *source);
+                }
+            } catch (...) {
+                destroy_range(target, i);
+                throw;
+            }
+            return source;
+        }
+    }
+
+    // Builds a detached chain of packed nodes from [first, last). With a known count each
+    // node is filled by one bulk copy.
+    template<typename Iterator, typename Sentinel>
+    node_chain make_chain(Iterator& first, const Sentinel& last, size_t count) {
+        node_chain chain;
+        try {
+            if (count == unknown_count) {
+                for (; first != last; ++first) {
+                    chain_emplace_back(chain, *first);
+                }
+                return chain;
+            }
+            while (count != 0) {
+                Node* node = allocate_node();
+                construct_node(node, 0, nullptr, nullptr);
+                chain_push_node(chain, node);
+                const size_t part = std::min(count, NodeMaxSize);
+                first = fill_block(node->slots(), std::move(first), part);
+                node->node_size = part;
+                chain.size += part;
+                count -= part;
+            }
+        } catch (...) {
+            free_chain(chain.first);
             throw;
         }
+        return chain;
     }
-    void push_front(const T& value) {
-        Node* allocated_node = nullptr;
-        Node* prev_head = head_;
+
+    // Appends [first, last): the tail's free slots first, then a chain of packed nodes.
+    // Strong guarantee. Returns the position of the first appended element.
+    template<typename Iterator, typename Sentinel>
+    ul_iterator<> append_from(Iterator first, const Sentinel& last, size_t count) {
+        NodeBase* old_tail = sentinel_.prev;
+        Node* tail = size_ != 0 && tail_node()->back_room() != 0 ? tail_node() : nullptr;
+        const size_t old_tail_size = tail ? tail->node_size : 0;
+        node_chain chain;
         try {
-            ++size_;
-            if (tail_ == nullptr && head_ == nullptr) {
-
-                Node* new_node = allocate_node();
-                construct_node(new_node, 1, nullptr, nullptr, nullptr);
-                new_node->data = allocate_t();
-                construct_t(new_node->data, value);
-                tail_ = new_node;
-                head_ = new_node;
-                return;
+            if (tail && count != unknown_count) {
+                const size_t in_tail = std::min(count, tail->back_room());
+                first = fill_block(tail->data() + tail->node_size, std::move(first), in_tail);
+                tail->node_size += in_tail;
+                count -= in_tail;
+            } else if (tail) {
+                for (; first != last && tail->back_room() != 0; ++first) {
+                    construct_t(tail->data() + tail->node_size, *first);
+                    ++tail->node_size;
+                }
+            }
+            chain = make_chain(first, last, count);
+        } catch (...) {
+            if (tail) {
+                destroy_range(tail->data() + old_tail_size, tail->node_size - old_tail_size);
+                tail->node_size = old_tail_size;
+            }
+            throw;
+        }
+        if (tail) {
+            size_ += tail->node_size - old_tail_size;
+            index_.on_resize(tail);
+        }
+        if (chain.first) {
+            link_chain_after(sentinel_.prev, chain);
+        }
+        if (tail && tail->node_size != old_tail_size) {
+            return ul_iterator<>(tail, old_tail_size);
+        }
+        return ul_iterator<>(old_tail->next, 0);
+    }
+
+    // Appends count elements constructed from args: the tail's free slots first, then
+    // packed nodes linked in one step. Strong guarantee.
+    template<typename... Args>
+    void append_copies(const size_t count, const Args&... args) {
+        Node* tail = size_ != 0 && tail_node()->back_room() != 0 ? tail_node() : nullptr;
+        const size_t old_tail_size = tail ? tail->node_size : 0;
+        const size_t in_tail = tail ? std::min(count, tail->back_room()) : 0;
+        node_chain chain;
+        try {
+            for (size_t i = 0; i < in_tail; ++i) {
+                construct_t(tail->data() + tail->node_size, args...);
+                ++tail->node_size;
+            }
+            for (size_t i = in_tail; i < count; ++i) {
+                chain_emplace_back(chain, args...);
+            }
+        } catch (...) {
+            free_chain(chain.first);
+            if (tail) {
+                destroy_range(tail->data() + old_tail_size, tail->node_size - old_tail_size);
+                tail->node_size = old_tail_size;
+            }
+            throw;
+        }
+        if (tail) {
+            size_ += in_tail;
+            index_.on_resize(tail);
+        }
+        if (chain.first) {
+            link_chain_after(sentinel_.prev, chain);
+        }
+    }
 
+    // Closes the gap from whichever side has fewer elements to shift.
+    void erase_in_node(Node* current_node, const size_t from, const size_t to) noexcept {
+        T* data = current_node->data();
+        const size_t node_size = current_node->node_size;
+        if (from < node_size - to) {
+            if constexpr (bitwise_copyable) {
+                move_bits(data + (to - from), data, from);
+            } else {
+                std::move_backward(data, data + from, data + to);
+                destroy_range(data, to - from);
+            }
+            current_node->offset += to - from;
+        } else {
+            if constexpr (bitwise_copyable) {
+                move_bits(data + from, data + to, node_size - to);
+            } else {
+                std::move(data + to, data + node_size, data + from);
+                destroy_range(data + (node_size - (to - from)), to - from);
             }
+        }
+        current_node->node_size -= to - from;
+        index_.on_resize(current_node);
+        size_ -= to - from;
+    }
 
-            if (head_->node_size != NodeMaxSize) {
+    void move_to_back(Node* from, const size_t count, Node* to) noexcept {
+        if (to->back_room() < count) {
+            realign(to, 0);
+        }
+        relocate(to->data() + to->node_size, from->data(), count);
+        to->node_size += count;
+        index_.on_resize(to);
+        from->offset += count;
+        from->node_size -= count;
+        index_.on_resize(from);
+    }
 
-                for (size_t i = head_->node_size; i > 0; --i) {
-                    head_->data[i] = head_->data[i - 1];
+    void move_to_front(Node* from, const size_t count, Node* to) noexcept {
+        if (to->offset < count) {
+            realign(to, NodeMaxSize - to->node_size);
+        }
+        relocate(to->data() - count, from->data() + (from->node_size - count), count);
+        to->offset -= count;
+        to->node_size += count;
+        from->node_size -= count;
+        index_.on_resize(to);
+        index_.on_resize(from);
+    }
+
+    // Restores BalancePolicy's fill threshold for a node that just lost elements.
+    // index is the in-node position of the element following the erased ones.
+    ul_iterator<> rebalance_after_erase(Node* current_node, const size_t index) noexcept {
+        constexpr size_t threshold = BalancePolicy::merge_threshold(NodeMaxSize);
+        if (current_node->node_size == 0) {
+            NodeBase* next_node = current_node->next;
+            check_node_empty(current_node);
+            if (next_node == &sentinel_) {
+                return end();
+            }
+            return rebalance_after_erase(as_node(next_node), 0);
+        }
+        if constexpr (threshold != 0
+            && std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>) {
+            if (current_node->node_size < threshold) {
+                if (current_node->next != &sentinel_) {
+                    Node* next_node = as_node(current_node->next);
+                    if (current_node->node_size + next_node->node_size <= NodeMaxSize) {
+                        move_to_back(next_node, next_node->node_size, current_node);
+                        check_node_empty(next_node);
+                    } else {
+                        const size_t count = (next_node->node_size - current_node->node_size) / 2;
+                        move_to_back(next_node, std::max<size_t>(count, 1), current_node);
+                    }
+                    return ul_iterator<>(current_node, index);
                 }
-                head_->data[0] = value;
-                ++head_->node_size;
-                return;
+                if (current_node->prev != &sentinel_) {
+                    Node* prev_node = as_node(current_node->prev);
+                    if (prev_node->node_size + current_node->node_size <= NodeMaxSize) {
+                        const size_t offset = prev_node->node_size;
+                        const size_t moved = current_node->node_size;
+                        move_to_back(current_node, moved, prev_node);
+                        check_node_empty(current_node);
+                        return index < moved ? ul_iterator<>(prev_node, offset + index) : end();
+                    }
+                    const size_t count = std::max<size_t>((prev_node->node_size - current_node->node_size) / 2, 1);
+                    move_to_front(prev_node, count, current_node);
+                    return index + count < current_node->node_size
+                        ? ul_iterator<>(current_node, index + count) : end();
+                }
+            }
+        }
+        if (index < current_node->node_size) {
+            return ul_iterator<>(current_node, index);
+        }
+        return ul_iterator<>(current_node->next, 0);
+    }
 
+    void take_nodes(unrolled_list& other) noexcept {
+        relink_sentinel(sentinel_, other.sentinel_);
+        size_ = other.size_;
+        index_ = other.index_;
+        other.size_ = 0;
+        other.index_.reset();
+    }
+
+    // node must not be full; the elements on the shorter side of index are shifted,
+    // as long as that side of the node has a free slot.
+    template<typename... Args>
+    ul_iterator<> emplace_into_node(Node* node, const size_t index, Args&&... args) {
+        T* data = node->data();
+        const size_t node_size = node->node_size;
+        if (node->offset != 0 && (index < node_size - index || node->back_room() == 0)) {
+            if (index == 0) {
+                construct_t(data - 1, std::forward<Args>(args)...);
+            } else if constexpr (bitwise_copyable) {
+                T value(std::forward<Args>(args)...);
+                move_bits(data - 1, data, index);
+                construct_t(data + (index - 1), std::move(value));
+            } else {
+                T value(std::forward<Args>(args)...);
+                construct_t(data - 1, std::move(data[0]));
+                std::move(data + 1, data + index, data);
+                data[index - 1] = std::move(value);
             }
+            --node->offset;
+        } else if (index == node_size) {
+            construct_t(data + node_size, std::forward<Args>(args)...);
+        } else if constexpr (bitwise_copyable) {
+            T value(std::forward<Args>(args)...);
+            move_bits(data + index + 1, data + index, node_size - index);
+            construct_t(data + index, std::move(value));
+        } else {
+            T value(std::forward<Args>(args)...);
+            construct_t(data + node_size, std::move(data[node_size - 1]));
+            std::move_backward(data + index, data + node_size - 1, data + node_size);
+            data[index] = std::move(value);
+        }
+        ++node->node_size;
+        index_.on_resize(node);
+        ++size_;
+        return ul_iterator<>(node, index);
+    }
 
-            Node* new_node = allocate_node();
-            construct_node(new_node, 1, nullptr, head_, nullptr);
-            new_node->data = allocate_t();
-            construct_t(new_node->data, value);
 
-            head_->prev = new_node;
-            head_ = new_node;
+    void push_back(const T& value) {
+        emplace_back(value);
+    }
+
+    void push_back(T&& value) {
+        emplace_back(std::move(value));
+    }
+
+    template<typename... Args>
+    reference emplace_back(Args&&... args) {
+        Node* node = back_node_with_room();
+        try {
+            construct_t(node->data() + node->node_size, std::forward<Args>(args)...);
         } catch (...) {
-            if (allocated_node) {
-                allocated_node->next->prev = nullptr;
-                delete_node(allocated_node);
+            check_node_empty(node);
+            throw;
+        }
+        ++node->node_size;
+        index_.on_resize(node);
+        ++size_;
+        return node->data()[node->node_size - 1];
+    }
+
+    void push_front(const T& value) {
+        emplace_front(value);
+    }
+
+    void push_front(T&& value) {
+        emplace_front(std::move(value));
+    }
+
+    template<typename... Args>
+    reference emplace_front(Args&&... args) {
+        NodeBase* head = sentinel_.next;
+        if (head != &sentinel_ && head->node_size != NodeMaxSize) {
+            Node* node = as_node(head);
+            if (node->offset != 0 || worth_realigning(node)) {
+                if (node->offset == 0) {
+                    realign(node, NodeMaxSize - node->node_size);
+                }
+                return *emplace_into_node(node, 0, std::forward<Args>(args)...);
             }
-            head_ = prev_head;
+        }
+
+        // a fresh head node fills from the back, so following push_fronts stay in place
+        Node* new_node = allocate_node();
+        construct_node(new_node, 0, head, &sentinel_);
+        try {
+            construct_t(new_node->slots() + (NodeMaxSize - 1), std::forward<Args>(args)...);
+        } catch (...) {
+            destroy_node(new_node);
+            recycle_node(new_node);
             throw;
         }
+        new_node->offset = NodeMaxSize - 1;
+        new_node->node_size = 1;
+        head->prev = new_node;
+        sentinel_.next = new_node;
+        index_link(new_node);
+        ++size_;
+        return new_node->data()[0];
     }
 
 
     void pop_back() noexcept {
-        if (is_empty_) {
+        if (size_ == 0) {
             return;
         }
 
         --size_;
-        if (size_ == 0) {
-            is_empty_ = true;
-        }
-
-        destroy_t(tail_->data + (tail_->node_size - 1));
-        --tail_->node_size;
+        Node* tail = tail_node();
+        destroy_t(tail->data() + (tail->node_size - 1));
+        --tail->node_size;
+        index_.on_resize(tail);
 
-        check_node_empty(tail_);
+        check_node_empty(tail);
     }
 
 
@@ -590,258 +1593,567 @@ unrolled_list(InputIterator first, InputIterator last, const allocator_type allo
         if (size_ == 0) {
             return;
         }
-        --size_;
-        if (size_ == 0) {
-            is_empty_ = true;
+        Node* head = head_node();
+        erase_in_node(head, 0, 1);
+        check_node_empty(head);
+    }
+
+    // Moves elements [index, node_size) of current_node into a new node linked right after it.
+    Node* split_node(Node* current_node, const size_t index) {
+        Node* new_node = create_node_after(current_node, 0);
+        T* source = current_node->data() + index;
+        const size_t count = current_node->node_size - index;
+        if constexpr (bitwise_copyable) {
+            move_bits(new_node->data(), source, count);
+            new_node->node_size = count;
+            current_node->node_size = index;
+            index_.on_resize(new_node);
+            index_.on_resize(current_node);
+            return new_node;
         }
-        ul_iterator<> it = begin();
-        while (it.current_index != head_->node_size - 1) {
-            *it = *(it + 1);
-            ++it;
+        try {
+            for (size_t i = 0; i < count; ++i) {
+                construct_t(new_node->data() + i, std::move_if_noexcept(source[i]));
+                ++new_node->node_size;
+            }
+        } catch (...) {
+            for (size_t i = 0; i < new_node->node_size; ++i) {
+                destroy_t(new_node->data() + i);
+            }
+            new_node->node_size = 0;
+            check_node_empty(new_node);
+            throw;
         }
-        destroy_t(head_->data + (head_->node_size - 1));
-        --head_->node_size;
-        check_node_empty(head_);
+        destroy_range(source, count);
+        current_node->node_size = index;
+        index_.on_resize(new_node);
+        index_.on_resize(current_node);
+        return new_node;
     }
 
+    // Returns the node that starts at position, splitting position's node if needed.
+    NodeBase* cut_before(const_iterator position) {
+        NodeBase* current_node = const_cast<NodeBase*>(position.current_node);
+        if (position.current_index == 0) {
+            return current_node;
+        }
+        if (position.current_index == current_node->node_size) {
+            return current_node->next;
+        }
+        return split_node(as_node(current_node), position.current_index);
+    }
 
-    ul_iterator<> insert(const_iterator position, const T& value) {
-        ++size_;
-
-        ul_iterator<> pos = position;
+    // Detaches the whole nodes [first, last) as a chain.
+    node_chain unlink_chain(NodeBase* first, NodeBase* last) noexcept {
+        node_chain chain;
+        if (first == last) {
+            return chain;
+        }
+        chain.first = as_node(first);
+        chain.last = as_node(last->prev);
+        for (NodeBase* node = first; node != last; node = node->next) {
+            chain.size += node->node_size;
+            index_.on_unlink(as_node(node));
+        }
+        first->prev->next = last;
+        last->prev = first->prev;
+        chain.first->prev = nullptr;
+        chain.last->next = nullptr;
+        size_ -= chain.size;
+        return chain;
+    }
 
-        if (pos == end()) {
-            push_back(value);
-            return ul_iterator<>(tail_, tail_->node_size - 1);
+    // Merges the nodes on both sides of a seam left by relinking, if BalancePolicy
+    // wants one of them fuller and both fit into one node.
+    void merge_seam(NodeBase* left) noexcept {
+        constexpr size_t threshold = BalancePolicy::merge_threshold(NodeMaxSize);
+        if constexpr (threshold != 0 && std::is_nothrow_move_constructible_v<T>) {
+            NodeBase* right = left->next;
+            if (left == &sentinel_ || right == &sentinel_) {
+                return;
+            }
+            if ((left->node_size < threshold || right->node_size < threshold)
+                && left->node_size + right->node_size <= NodeMaxSize) {
+                move_to_back(as_node(right), right->node_size, as_node(left));
+                check_node_empty(as_node(right));
+            }
         }
+    }
 
-        size_t& current_node_size = pos.current_node->node_size;
-        Node* current_node = pos.current_node;
-        T* new_t_position = pos.current_node->data + current_node_size;
+    template<typename... Args>
+    ul_iterator<> emplace(const_iterator position, Args&&... args) {
+        if (position == cend()) {
+            emplace_back(std::forward<Args>(args)...);
+            return ul_iterator<>(sentinel_.prev, sentinel_.prev->node_size - 1);
+        }
 
-        if (current_node_size != NodeMaxSize) {
-            construct_t(new_t_position, *(pos.current_node->data + (current_node_size - 1)));
-            if (pos.current_index == current_node_size - 1) {
-                *pos = value;
-            } else {
-                ul_iterator<> it(current_node, current_node_size - 1);
-                while (it != pos) {
-                    *it = *(it-1);
-                    --it;
-                }
-                *it = value;
+        Node* current_node = node_of(position);
+        const size_t index = position.current_index;
+
+        if (current_node->node_size == NodeMaxSize) {
+            // both halves keep an element unless a node holds only one, in which case
+            // current_node is emptied and must not stay linked if construction throws
+            constexpr size_t split = std::clamp<size_t>(
+                BalancePolicy::split_point(NodeMaxSize), NodeMaxSize > 1 ? 1 : 0, NodeMaxSize - 1);
+            Node* new_node = split_node(current_node, split);
+            if (index > split) {
+                return emplace_into_node(new_node, index - split, std::forward<Args>(args)...);
             }
-            ++current_node_size;
-            ul_iterator<> result(current_node, current_node_size - 1);
-            return result;
-        }
-        Node* new_node = create_node_after(current_node, 1);
-        construct_t(new_node->data, current_node->data[NodeMaxSize - 1]);
-        if (pos.current_index == current_node_size - 1) {
-            construct_t(new_node->data, current_node->data[NodeMaxSize - 1]);
-            current_node->data[NodeMaxSize - 1] = value;
-        } else {
-            ul_iterator<> it(current_node, current_node_size - 1);
-            while (it != pos) {
-                *it = *(it-1);
-                --it;
+            if constexpr (split == 0) {
+                try {
+                    return emplace_into_node(current_node, index, std::forward<Args>(args)...);
+                } catch (...) {
+                    check_node_empty(current_node);
+                    throw;
+                }
             }
-            *it = value;
         }
 
-        ul_iterator<> result(current_node, current_node_size - 1);
-        return result;
+        return emplace_into_node(current_node, index, std::forward<Args>(args)...);
     }
 
-    ul_iterator<> insert(iterator position, const T& value) {
-        ++size_;
+    ul_iterator<> insert(const_iterator position, const T& value) {
+        return emplace(position, value);
+    }
 
-        ul_iterator<> pos = position;
-        Node* allocated_node;
-        Node* prev_value_node = position.current_node;
-        Node* prev_next_value_node = position.current_node->next;
-        size_t current_size = size_;
-        Node* current_tail = tail_;
-        Node* current_head = head_;
+    ul_iterator<> insert(const_iterator position, T&& value) {
+        return emplace(position, std::move(value));
+    }
 
-        try {
-            if (pos == end()) {
-                push_back(value);
-                return ul_iterator<>(tail_, tail_->node_size - 1);
+    ul_iterator<> insert(const_iterator position, const size_t count, const T& value) {
+        auto values = std::views::iota(size_t{0}, count)
+            | std::views::transform([&value](size_t) -> const T& { return value; });
+        return insert(position, values.begin(), values.end());
+    }
+
+    template<typename InputIterator, typename = std::enable_if_t<!std::is_integral_v<InputIterator>>>
+    ul_iterator<> insert(const_iterator position, InputIterator first, InputIterator last) {
+        return insert_from(position, first, last, count_of(first, last));
+    }
+
+    template<ul_container_compatible_range<T> Range>
+    ul_iterator<> insert_range(const_iterator position, Range&& range) {
+        const size_t count = count_of_range(range);
+        return insert_from(position, std::ranges::begin(range), std::ranges::end(range), count);
+    }
+
+    template<ul_container_compatible_range<T> Range>
+    void append_range(Range&& range) {
+        const size_t count = count_of_range(range);
+        append_from(std::ranges::begin(range), std::ranges::end(range), count);
+    }
+
+    template<ul_container_compatible_range<T> Range>
+    void prepend_range(Range&& range) {
+        insert_range(cbegin(), std::forward<Range>(range));
+    }
+
+    // Inserts [first, last) of count elements (or unknown_count) before position. Elements
+    // go into position's node if they fit there, otherwise into a chain of packed nodes
+    // linked in after the tail of that node is moved to the chain's end.
+    template<typename Iterator, typename Sentinel>
+    ul_iterator<> insert_from(const_iterator position, Iterator first, const Sentinel& last, const size_t count) {
+        const size_t index = position.current_index;
+        if (count == 0 || first == last) {
+            return ul_iterator<>(const_cast<NodeBase*>(position.current_node), index);
+        }
+        if (position == cend()) {
+            return append_from(std::move(first), last, count);
+        }
+        Node* current_node = node_of(position);
+
+        if (count <= NodeMaxSize - current_node->node_size) {
+            size_t i = index;
+            try {
+                for (; first != last; ++first, ++i) {
+                    emplace_into_node(current_node, i, *first);
+                }
+            } catch (...) {
+                // each emplace_into_node is strong, so dropping the inserted prefix
+                // restores the node
+                if (i != index) {
+                    erase_in_node(current_node, index, i);
+                }
+                throw;
             }
+            return ul_iterator<>(current_node, index);
+        }
 
-            size_t& current_node_size = pos.current_node->node_size;
-            Node* current_node = pos.current_node;
-            T* new_t_position = pos.current_node->data + current_node_size;
+        node_chain chain = make_chain(first, last, count);
 
-            if (current_node_size != NodeMaxSize) {
-                construct_t(new_t_position, *(pos.current_node->data + (current_node_size - 1)));
-                if (pos.current_index == current_node_size - 1) {
-                    *pos = value;
-                } else {
-                    ul_iterator<> it(current_node, current_node_size - 1);
-                    while (it != pos) {
-                        *it = *(it-1);
-                        --it;
-                    }
-                    *it = value;
-                }
-                ++current_node_size;
-                ul_iterator<> result(current_node, current_node_size - 1);
-                return result;
-            }
-            Node* new_node = create_node_after(current_node, 1);
-            allocated_node = new_node;
-            construct_t(new_node->data, current_node->data[NodeMaxSize - 1]);
-            if (pos.current_index == current_node_size - 1) {
-                construct_t(new_node->data, current_node->data[NodeMaxSize - 1]);
-                current_node->data[NodeMaxSize - 1] = value;
+        if (index == 0) {
+            link_chain_after(current_node->prev, chain);
+            return ul_iterator<>(chain.first, 0);
+        }
+
+        const size_t moved = current_node->node_size - index;
+        T* source = current_node->data() + index;
+        try {
+            if (moved > NodeMaxSize - chain.last->node_size) {
+                Node* split_node = allocate_node();
+                construct_node(split_node, 0, nullptr, chain.last);
+                chain.last->next = split_node;
+                chain.last = split_node;
+            }
+            T* target = chain.last->data() + chain.last->node_size;
+            if constexpr (bitwise_copyable) {
+                move_bits(target, source, moved);
+                chain.last->node_size += moved;
             } else {
-                ul_iterator<> it(current_node, current_node_size - 1);
-                while (it != pos) {
-                    *it = *(it-1);
-                    --it;
+                for (size_t i = 0; i < moved; ++i) {
+                    construct_t(target + i, std::move(source[i]));
+                    ++chain.last->node_size;
                 }
-                *it = value;
             }
-
-            ul_iterator<> result(current_node, current_node_size - 1);
-            return result;
         } catch (...) {
-            position.current_node = prev_value_node;
-            position.current_node->next = prev_next_value_node;
-            size_ = current_size;
-            head_ = current_head;
-            tail_ = current_tail;
-
+            free_chain(chain.first);
             throw;
         }
+        destroy_range(source, moved);
+        current_node->node_size = index;
+        index_.on_resize(current_node);
+        size_ -= moved;
+        chain.size += moved;
+
+        link_chain_after(current_node, chain);
+        return ul_iterator<>(chain.first, 0);
     }
 
-    ul_iterator<> insert(const_iterator position, const size_t count, const T& value) {
-        ul_iterator<> pos = position;
-        for (int i = 0; i < count; ++i) {
-            insert(pos, value);
+    ul_iterator<> insert(const_iterator position, std::initializer_list<T> list) {
+        return insert(position, list.begin(), list.end());
+    }
+
+    void check_node_empty(Node* current_node) {
+        if (current_node->node_size == 0) {
+            current_node->prev->next = current_node->next;
+            current_node->next->prev = current_node->prev;
+            index_.on_unlink(current_node);
+            delete_node(current_node);
         }
-        return pos;
     }
 
-    template<typename InputIterator, typename = std::enable_if_t<!std::is_integral_v<InputIterator>>>
-    ul_iterator<> insert(const_iterator position, InputIterator first, InputIterator last) {
-        ul_iterator<> pos = position;
-        --last;
-        while (last != first) {
-            insert(pos, *last);
-            --last;
+    ul_iterator<> erase(const_iterator position) noexcept {
+        Node* current_node = node_of(position);
+        const size_t index = position.current_index;
+        erase_in_node(current_node, index, index + 1);
+
+        return rebalance_after_erase(current_node, index);
+    }
+
+    ul_iterator<> erase(const_iterator first, const_iterator last) noexcept {
+        Node* first_node = node_of(first);
+        NodeBase* last_node = const_cast<NodeBase*>(last.current_node);
+        const size_t first_index = first.current_index;
+        const size_t last_index = last.current_index;
+        if (first == last) {
+            return ul_iterator<>(last_node, last_index);
+        }
+
+        if (first_node == last_node) {
+            erase_in_node(first_node, first_index, last_index);
+            return rebalance_after_erase(first_node, first_index);
+        }
+
+        erase_in_node(first_node, first_index, first_node->node_size);
+        NodeBase* current_node = first_node->next;
+        while (current_node != last_node) {
+            NodeBase* next_node = current_node->next;
+            size_ -= current_node->node_size;
+            index_.on_unlink(as_node(current_node));
+            delete_node(as_node(current_node));
+            current_node = next_node;
         }
-        insert(pos, *first);
-        return pos;
+        first_node->next = last_node;
+        last_node->prev = first_node;
+        if (last_node != &sentinel_) {
+            erase_in_node(as_node(last_node), 0, last_index);
+        }
+
+        return rebalance_after_erase(first_node, first_node->node_size);
     }
 
-    ul_iterator<> insert(const_iterator position, std::initializer_list<T> list) {
-        ul_iterator<> pos = position;
-        insert(pos, list.begin(), list.end());
-        return pos;
+    void clear() noexcept {
+        if (!releases_in_bulk()) {
+            NodeBase* current_node = sentinel_.next;
+            while (current_node != &sentinel_) {
+                NodeBase* temp = current_node;
+                current_node = current_node->next;
+                delete_node(as_node(temp));
+            }
+        }
+        sentinel_.next = sentinel_.prev = &sentinel_;
+        size_ = 0;
+        index_.reset();
     }
 
-    void check_node_empty(Node* current_node) {
-        if (current_node->node_size == 0) {
-            if (current_node == head_ && current_node == tail_) {
-                head_ = nullptr;
-                tail_ = nullptr;
+    /*
+        splice/split/concat relink whole nodes; only the nodes holding position, first and
+        last are split, and the seams are merged back per BalancePolicy. Elements of the
+        transferred nodes are not touched. The allocators of both lists must compare equal.
+        With ul_order_statistics_index every transferred node is re-indexed (O(log) each).
+    */
+    void splice(const_iterator position, unrolled_list& other) {
+        if (&other == this || other.empty()) {
+            return;
+        }
+        NodeBase* next_node = cut_before(position);
+        node_chain chain{as_node(other.sentinel_.next), as_node(other.sentinel_.prev), other.size_};
+        other.sentinel_.next = other.sentinel_.prev = &other.sentinel_;
+        other.size_ = 0;
+        other.index_.reset();
+
+        NodeBase* prev_node = next_node->prev;
+        link_chain_after(prev_node, chain);
+        merge_seam(chain.last);
+        merge_seam(prev_node);
+    }
+
+    void splice(const_iterator position, unrolled_list&& other) {
+        splice(position, other);
+    }
+
+    void splice(const_iterator position, unrolled_list& other, const_iterator first, const_iterator last) {
+        if (first == last) {
+            return;
+        }
+        NodeBase* first_node;
+        NodeBase* last_node;
+        NodeBase* next_node;
+        if (&other == this) {
+            // cuts inside one node have to go from the back so the earlier ones stay valid
+            std::array<std::pair<const_iterator, NodeBase**>, 3> cuts{{
+                {position, &next_node}, {first, &first_node}, {last, &last_node}}};
+            std::sort(cuts.begin(), cuts.end(), [](const auto& lhs, const auto& rhs) {
+                if (lhs.first.current_node != rhs.first.current_node) {
+                    return std::less<>()(lhs.first.current_node, rhs.first.current_node);
+                }
+                return lhs.first.current_index > rhs.first.current_index;
+            });
+            for (auto& [cut, node] : cuts) {
+                *node = cut_before(cut);
+            }
+        } else {
+            last_node = other.cut_before(last);
+            first_node = other.cut_before(first);
+            next_node = cut_before(position);
+        }
+        if (next_node == first_node || next_node == last_node) {
+            return;
+        }
+
+        NodeBase* other_seam = first_node->prev;
+        node_chain chain = other.unlink_chain(first_node, last_node);
+        other.merge_seam(other_seam);
+        NodeBase* prev_node = next_node->prev;
+        link_chain_after(prev_node, chain);
+        merge_seam(chain.last);
+        merge_seam(prev_node);
+    }
+
+    void splice(const_iterator position, unrolled_list&& other, const_iterator first, const_iterator last) {
+        splice(position, other, first, last);
+    }
+
+    // Moves [position, end()) into a new list sharing this list's allocator.
+    unrolled_list split(const_iterator position) {
+        unrolled_list result(t_alloc_);
+        node_chain chain = unlink_chain(cut_before(position), &sentinel_);
+        if (chain.first) {
+            result.link_chain_after(&result.sentinel_, chain);
+        }
+        return result;
+    }
+
+    void concat(unrolled_list&& other) {
+        splice(cend(), other);
+    }
+
+    /*
+        Sorts every node's block in place, then merges runs of nodes bottom-up. Stable.
+        If compare throws, all elements stay in the list in unspecified order.
+    */
+    template<typename Compare = std::less<>>
+    void sort(Compare compare = Compare()) {
+        if (size_ < 2) {
+            return;
+        }
+        // binary insertion sort: compare never runs while an element is moved out,
+        // and an already sorted node costs no moves
+        for (NodeBase* node = sentinel_.next; node != &sentinel_; node = node->next) {
+            T* data = as_node(node)->data();
+            for (T* current = data + 1; current < data + node->node_size; ++current) {
+                T* position = std::upper_bound(data, current, *current, compare);
+                if (position != current) {
+                    std::rotate(position, current, current + 1);
+                }
             }
+        }
 
-            if (current_node == tail_) {
-                if (current_node->prev) {
-                    current_node->prev->next = current_node->next;
+        node_chain rest = unlink_chain(sentinel_.next, &sentinel_);
+        // runs[k] holds about 2^k merged nodes, older elements in higher k
+        std::array<node_chain, std::numeric_limits<size_t>::digits> runs{};
+        node_chain carry;
+        node_chain merged;
+        try {
+            while (rest.first) {
+                chain_push_node(carry, chain_pop_node(rest));
+                size_t k = 0;
+                for (; runs[k].first; ++k) {
+                    merge_chains(runs[k], carry, merged, compare);
+                    carry = std::exchange(merged, node_chain{});
                 }
-                tail_ = current_node->prev;
+                runs[k] = std::exchange(carry, node_chain{});
             }
-            else if (current_node == head_) {
-                if (current_node->next) {
-                    current_node->next->prev = current_node->prev;
+            for (auto& run : runs) {
+                if (run.first) {
+                    merge_chains(run, carry, merged, compare);
+                    carry = std::exchange(merged, node_chain{});
                 }
-                head_ = current_node->next;
             }
-            else {
-                if (current_node->prev) {
-                    current_node->prev->next = current_node->next;
+        } catch (...) {
+            for (node_chain* chain : {&merged, &carry, &rest}) {
+                if (chain->first) {
+                    link_chain_after(sentinel_.prev, *chain);
                 }
-                if (current_node->next) {
-                    current_node->next->prev = current_node->prev;
+            }
+            for (auto& run : runs) {
+                if (run.first) {
+                    link_chain_after(sentinel_.prev, run);
                 }
             }
-            delete_node(current_node);
+            throw;
         }
+        link_chain_after(&sentinel_, carry);
     }
 
-    ul_iterator<> erase(const_iterator position) noexcept {
-        --size_;
-        ul_iterator<> pos = position;
-        size_t& current_node_size = pos.current_node->node_size;
-        Node* current_node = pos.current_node;
-
-        if (pos.current_index == current_node_size - 1) {
-            destroy_t(&(*pos));
-            --current_node_size;
-            if (current_node == tail_) {
-                return end();
-            }
-            ul_iterator<> result(current_node->next, 0);
-            check_node_empty(current_node);
-            return result;
+    // Merges the sorted other into this sorted list, elements of this list first on ties.
+    // The allocators of both lists must compare equal.
+    template<typename Compare = std::less<>>
+    void merge(unrolled_list& other, Compare compare = Compare()) {
+        if (&other == this || other.empty()) {
+            return;
         }
-        ul_iterator<> it(pos);
-        while (it.current_index != current_node_size - 1) {
-            *it = *(it + 1);
-            ++it;
+        node_chain left = unlink_chain(sentinel_.next, &sentinel_);
+        node_chain right = other.unlink_chain(other.sentinel_.next, &other.sentinel_);
+        node_chain merged;
+        try {
+            merge_chains(left, right, merged, compare);
+        } catch (...) {
+            chain_append(merged, left);
+            if (merged.first) {
+                link_chain_after(&sentinel_, merged);
+            }
+            if (right.first) {
+                other.link_chain_after(&other.sentinel_, right);
+            }
+            throw;
         }
-        destroy_t(current_node->data + (current_node_size-1));
-        --current_node_size;
-        return pos;
+        link_chain_after(&sentinel_, merged);
     }
 
-    template<typename InputIterator>
-    ul_iterator<> erase(InputIterator first, InputIterator last) {
-        size_t count = 0;
-        ul_iterator<> result(first);
-        while (first != last) {
-            ++first;
-            ++count;
-        }
-        for (int i = 0; i < count; ++i) {
-            result = erase(result);
+    template<typename Compare = std::less<>>
+    void merge(unrolled_list&& other, Compare compare = Compare()) {
+        merge(other, compare);
+    }
+
+    /*
+        remove_if/unique move the survivors forward over the removed elements in one pass
+        and then drop the moved-from tail with a single range erase, which frees whole
+        nodes in bulk. If the predicate throws, the elements processed so far are
+        already removed and the rest are kept.
+    */
+    template<typename Predicate>
+    size_t remove_if(Predicate predicate) {
+        const size_t old_size = size_;
+        iterator write = begin();
+        iterator read = begin();
+        try {
+            for (; read != end(); ++read) {
+                if (!predicate(*read)) {
+                    if (write != read) {
+                        *write = std::move(*read);
+                    }
+                    ++write;
+                }
+            }
+        } catch (...) {
+            erase(write, read);
+            throw;
         }
-        return result;
+        erase(write, end());
+        return old_size - size_;
     }
 
-    void clear() noexcept {
-        Node* current_node = head_;
-        while(current_node) {
-            Node* temp = current_node;
-            current_node = current_node->next;
-            delete_node(temp);
+    // value is copied first, as it may refer to an element of this list
+    size_t remove(const T& value) {
+        const T target = value;
+        return remove_if([&target](const T& element) { return element == target; });
+    }
+
+    template<typename BinaryPredicate = std::equal_to<>>
+    size_t unique(BinaryPredicate predicate = BinaryPredicate()) {
+        if (size_ < 2) {
+            return 0;
         }
-        is_empty_ = true;
-        size_ = 0;
-        head_ = tail_ = nullptr;
+        const size_t old_size = size_;
+        iterator write = begin();
+        iterator read = std::next(begin());
+        try {
+            for (; read != end(); ++read) {
+                if (!predicate(*write, *read)) {
+                    ++write;
+                    if (write != read) {
+                        *write = std::move(*read);
+                    }
+                }
+            }
+        } catch (...) {
+            erase(std::next(write), read);
+            throw;
+        }
+        erase(std::next(write), end());
+        return old_size - size_;
     }
 
+    /*
+        assign overwrites the existing elements in place and then erases the surplus or
+        appends the rest, so the nodes already owned are reused. Basic guarantee.
+    */
     template <typename InputIterator, typename = std::enable_if_t<!std::is_integral_v<InputIterator>>>
     void assign(InputIterator first, InputIterator last) {
+        assign_from(first, last);
+    }
+
+    template<ul_container_compatible_range<T> Range>
+    void assign_range(Range&& range) {
+        assign_from(std::ranges::begin(range), std::ranges::end(range));
+    }
+
+    template<typename Iterator, typename Sentinel>
+    void assign_from(Iterator first, const Sentinel& last) {
         ul_iterator<> it = begin();
-        while (first != last) {
+        for (; it != end() && first != last; ++it, ++first) {
             *it = *first;
-            ++it;
-            ++first;
+        }
+        if (first == last) {
+            erase(it, end());
+        } else {
+            const size_t count = count_of(first, last);
+            append_from(std::move(first), last, count);
         }
     }
 
     void assign(const size_t count, const T& value) {
+        const T copy = value;
         ul_iterator<> it = begin();
-        for (int i = 0; i < count; ++i) {
-            *it = value;
-            ++it;
+        size_t assigned = 0;
+        for (; it != end() && assigned < count; ++it, ++assigned) {
+            *it = copy;
+        }
+        if (assigned == count) {
+            erase(it, end());
+        } else {
+            append_copies(count - assigned, copy);
         }
     }
 
@@ -851,24 +2163,11 @@ unrolled_list(InputIterator first, InputIterator last, const allocator_type allo
 
 
     ul_iterator<> begin() {
-        if (size_ == 0) {
-            return ul_iterator(&sentinel_,0);
-        }
-        return iterator(head_,0);
+        return iterator(sentinel_.next, 0);
     }
 
     ul_iterator<true> begin() const {
-        if (size_ == 0) {
-            return ul_iterator<true>(&sentinel_, 0);
-        }
-        return ul_iterator<true>(head_,0);
-    }
-
-    ul_iterator<true> cbegin()  {
-        if (size_ == 0) {
-            return ul_iterator(&sentinel_,0);
-        }
-        return ul_iterator<true>(head_,0);
+        return ul_iterator<true>(sentinel_.next, 0);
     }
 
     reverse_iterator rbegin() {
@@ -880,10 +2179,7 @@ unrolled_list(InputIterator first, InputIterator last, const allocator_type allo
     }
 
     ul_iterator<true> cbegin() const {
-        if (size_ == 0) {
-            return ul_iterator<true>(&sentinel_, 0);
-        }
-        return ul_iterator<true>(head_,0);
+        return ul_iterator<true>(sentinel_.next, 0);
     }
 
     const_reverse_iterator crbegin() const {
@@ -891,30 +2187,23 @@ unrolled_list(InputIterator first, InputIterator last, const allocator_type allo
     }
 
     ul_iterator<> end() {
-        if (size_ == 0) {
-            return ul_iterator(&sentinel_,0);
-        }
-        return ul_iterator(tail_->next, 0);
+        return iterator(&sentinel_, 0);
     }
 
     ul_iterator<true> end() const {
-        if (size_ == 0) {
-            return ul_iterator<true>(&sentinel_, 0);
-        }
-        return ul_iterator<true>(tail_->next, 0);
+        return ul_iterator<true>(&sentinel_, 0);
     }
 
-    ul_iterator<true> cend() {
-        if (size_ == 0) {
-            return ul_iterator(&sentinel_,0);
-        }
-        return ul_iterator<true>(tail_->next, 0);
-    }
     ul_iterator<true> cend() const {
-        if (size_ == 0) {
-            return ul_iterator<true>(&sentinel_, 0);
-        }
-        return ul_iterator<true>(tail_->next, 0);
+        return ul_iterator<true>(&sentinel_, 0);
+    }
+
+    std::ranges::subrange<segment_iterator> segments() {
+        return {segment_iterator(sentinel_.next), segment_iterator(&sentinel_)};
+    }
+
+    std::ranges::subrange<const_segment_iterator> segments() const {
+        return {const_segment_iterator(sentinel_.next), const_segment_iterator(&sentinel_)};
     }
 
     reverse_iterator rend() {
@@ -937,11 +2226,11 @@ unrolled_list(InputIterator first, InputIterator last, const allocator_type allo
     }
 
     T& back() {
-        return tail_->data[tail_->node_size-1];
+        return tail_node()->data()[tail_node()->node_size - 1];
     }
 
     const T& back() const {
-        return tail_->data[tail_->node_size-1];
+        return tail_node()->data()[tail_node()->node_size - 1];
     }
 
     size_t size() {
@@ -956,6 +2245,228 @@ unrolled_list(InputIterator first, InputIterator last, const allocator_type allo
         return node_allocator_traits::max_size(node_alloc_) * NodeMaxSize;
     }
 
+    reference operator[](const size_t position) {
+        return *nth(position);
+    }
+
+    const_reference operator[](const size_t position) const {
+        return *nth(position);
+    }
+
+    reference at(const size_t position) {
+        if (position >= size_) {
+            throw std::out_of_range("unrolled_list::at");
+        }
+        return *nth(position);
+    }
+
+    const_reference at(const size_t position) const {
+        if (position >= size_) {
+            throw std::out_of_range("unrolled_list::at");
+        }
+        return *nth(position);
+    }
+
+    ul_iterator<> nth(size_t position) {
+        if (position >= size_) {
+            return end();
+        }
+        if constexpr (IndexPolicy::indexed) {
+            Node* node = index_tree::find(index_.root, position);
+            return ul_iterator<>(node, position);
+        } else {
+            if (position < size_ / 2) {
+                Node* node = head_node();
+                while (position >= node->node_size) {
+                    position -= node->node_size;
+                    node = as_node(node->next);
+                }
+                return ul_iterator<>(node, position);
+            }
+            size_t from_back = size_ - position;
+            Node* node = tail_node();
+            while (from_back > node->node_size) {
+                from_back -= node->node_size;
+                node = as_node(node->prev);
+            }
+            return ul_iterator<>(node, node->node_size - from_back);
+        }
+    }
+
+    ul_iterator<true> nth(const size_t position) const {
+        return const_cast<unrolled_list*>(this)->nth(position);
+    }
+
+    size_t index_of(const_iterator position) const {
+        if (position == cend()) {
+            return size_;
+        }
+        if constexpr (IndexPolicy::indexed) {
+            return index_tree::rank(static_cast<const Node*>(position.current_node)) + position.current_index;
+        } else {
+            size_t result = position.current_index;
+            for (const NodeBase* node = position.current_node->prev; node != &sentinel_; node = node->prev) {
+                result += node->node_size;
+            }
+            return result;
+        }
+    }
+
+    void reserve_nodes(const size_t count) {
+        if (node_cache_limit_ < count) {
+            node_cache_limit_ = count;
+        }
+        while (free_count_ < count) {
+            Node* node = node_allocator_traits::allocate(node_alloc_, 1);
+            recycle_node(node);
+        }
+    }
+
+    // Number of elements the list can hold before push_back has to allocate a node.
+    size_t capacity() const noexcept {
+        const size_t tail_room = size_ != 0 ? tail_node()->back_room() : 0;
+        return size_ + tail_room + free_count_ * NodeMaxSize;
+    }
+
+    // Preallocates enough cached nodes that the list grows to count elements at the back
+    // without allocating.
+    void reserve(const size_t count) {
+        if (count <= capacity()) {
+            return;
+        }
+        if (count > max_size()) {
+            throw std::length_error("unrolled_list::reserve");
+        }
+        const size_t missing = count - capacity();
+        reserve_nodes(free_count_ + (missing + NodeMaxSize - 1) / NodeMaxSize);
+    }
+
+    void resize(const size_t count) {
+        resize_impl(count);
+    }
+
+    void resize(const size_t count, const T& value) {
+        resize_impl(count, value);
+    }
+
+    template<typename... Args>
+    void resize_impl(const size_t count, const Args&... args) {
+        if (count < size_) {
+            erase(begin() + count, end());
+        } else if (count > size_) {
+            append_copies(count - size_, args...);
+        }
+    }
+
+    /*
+        Packs the elements into full nodes, front to back, frees the emptied nodes and
+        releases the node cache. Elements are only moved for nothrow-movable T.
+    */
+    void shrink_to_fit() noexcept {
+        if constexpr (std::is_nothrow_move_constructible_v<T>) {
+            for (NodeBase* target = sentinel_.next; target != &sentinel_; target = target->next) {
+                Node* node = as_node(target);
+                while (node->node_size != NodeMaxSize && node->next != &sentinel_) {
+                    Node* source = as_node(node->next);
+                    move_to_back(source, std::min(NodeMaxSize - node->node_size, source->node_size), node);
+                    check_node_empty(source);
+                }
+            }
+        }
+        release_node_cache();
+    }
+
+    void set_node_cache_limit(const size_t limit) noexcept {
+        node_cache_limit_ = limit;
+        trim_node_cache(limit);
+    }
+
+    size_t node_cache_limit() const noexcept {
+        return node_cache_limit_;
+    }
+
+    size_t cached_nodes() const noexcept {
+        return free_count_;
+    }
+
+    // Writes the list to path in the ul_file_header format, one record per node, through
+    // a ul_file_buffer_size stream buffer. Throws std::ios_base::failure if writing fails.
+    void save(const std::filesystem::path& path) const requires bitwise_copyable {
+        const auto buffer = std::make_unique_for_overwrite<char[]>(ul_file_buffer_size);
+        std::ofstream out;
+        out.rdbuf()->pubsetbuf(buffer.get(), ul_file_buffer_size);
+        out.open(path, std::ios::binary | std::ios::trunc);
+
+        ul_file_header header = ul_file_header::describe<T>(size_, 0);
+        write_padded(out, &header, sizeof(header));
+        for (const NodeBase* node = sentinel_.next; node != &sentinel_; node = node->next) {
+            const std::uint64_t node_size = node->node_size;
+            write_padded(out, &node_size, sizeof(node_size));
+            write_padded(out, static_cast<const Node*>(node)->data(), node->node_size * sizeof(T));
+            ++header.node_count;
+        }
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.close();
+        if (!out) {
+            throw std::ios_base::failure("unrolled_list::save");
+        }
+    }
+
+    /*
+        Replaces the contents with a file written by save(), reading every record straight
+        into node storage. A record longer than NodeMaxSize is spread over several nodes.
+        Throws std::ios_base::failure if the file cannot be read or was not saved from a
+        list of this element type; the list is then unchanged.
+    */
+    void load(const std::filesystem::path& path) requires bitwise_copyable {
+        const auto buffer = std::make_unique_for_overwrite<char[]>(ul_file_buffer_size);
+        std::ifstream in;
+        in.rdbuf()->pubsetbuf(buffer.get(), ul_file_buffer_size);
+        in.open(path, std::ios::binary);
+        if (!in.is_open()) {
+            throw std::ios_base::failure("unrolled_list::load: cannot open file");
+        }
+
+        ul_file_header header;
+        read_padded(in, &header, sizeof(header));
+        if (!in || !header.holds<T>()) {
+            throw std::ios_base::failure("unrolled_list::load: not a file of this element type");
+        }
+        node_chain chain;
+        try {
+            for (std::uint64_t i = 0; i < header.node_count; ++i) {
+                std::uint64_t node_size = 0;
+                read_padded(in, &node_size, sizeof(node_size));
+                for (std::uint64_t left = node_size; left != 0 && in;) {
+                    Node* node = allocate_node();
+                    construct_node(node, 0, nullptr, nullptr);
+                    chain_push_node(chain, node);
+                    const size_t part = static_cast<size_t>(std::min<std::uint64_t>(left, NodeMaxSize));
+                    in.read(reinterpret_cast<char*>(node->slots()), static_cast<std::streamsize>(part * sizeof(T)));
+                    node->node_size = part;
+                    chain.size += part;
+                    left -= part;
+                }
+                const size_t bytes = static_cast<size_t>(node_size) * sizeof(T);
+                in.ignore(static_cast<std::streamsize>(ul_file_round_up(bytes, ul_file_alignment<T>) - bytes));
+                if (!in) {
+                    throw std::ios_base::failure("unrolled_list::load: truncated file");
+                }
+            }
+            if (chain.size != header.size) {
+                throw std::ios_base::failure("unrolled_list::load: corrupt file");
+            }
+        } catch (...) {
+            free_chain(chain.first);
+            throw;
+        }
+        clear();
+        if (chain.first) {
+            link_chain_after(&sentinel_, chain);
+        }
+    }
+
     allocator_type get_allocator() const noexcept {
         return t_alloc_;
     }
@@ -971,15 +2482,140 @@ unrolled_list(InputIterator first, InputIterator last, const allocator_type allo
         return !(*this == other);
     }
 
-    void swap(unrolled_list& other) {
-
-        std::swap(tail_, other.tail_);
-        std::swap(head_, other.head_);
+    // Without propagate_on_container_swap the allocators must compare equal. The node
+    // caches follow the nodes, so each cache stays with the allocator it came from.
+    void swap(unrolled_list& other) noexcept {
+        if constexpr (t_allocator_traits::propagate_on_container_swap::value) {
+            using std::swap;
+            swap(t_alloc_, other.t_alloc_);
+            swap(node_alloc_, other.node_alloc_);
+        }
+        NodeBase chain;
+        relink_sentinel(chain, sentinel_);
+        relink_sentinel(sentinel_, other.sentinel_);
+        relink_sentinel(other.sentinel_, chain);
         std::swap(size_, other.size_);
+        std::swap(index_, other.index_);
+        std::swap(free_nodes_, other.free_nodes_);
+        std::swap(free_count_, other.free_count_);
+        trim_node_cache(node_cache_limit_);
+        other.trim_node_cache(other.node_cache_limit_);
     }
 
     bool empty() const {
-        return is_empty_;
+        return size_ == 0;
     }
 
 };
+
+namespace unrolled_list_pmr {
+
+template<typename T, size_t NodeMaxSize = 10,
+         typename IndexPolicy = ul_no_index, typename BalancePolicy = ul_half_balance>
+using unrolled_list = ::unrolled_list<T, NodeMaxSize, std::pmr::polymorphic_allocator<T>, IndexPolicy, BalancePolicy>;
+
+}
+
+/*
+    Segmented versions of hot algorithms. For unrolled_list iterators the work runs as a
+    plain loop over each node's contiguous block, so it can be vectorised; any other
+    iterator falls back to the std algorithm.
+*/
+template<typename Iterator>
+concept ul_segmented_iterator = requires { requires Iterator::is_segmented; };
+
+// Segmented iterators whose segments are paged in one at a time while visited, such as
+// those of external_unrolled_list; they must not be walked from several threads.
+template<typename Iterator>
+concept ul_paged_segments = ul_segmented_iterator<Iterator> && requires { requires Iterator::is_paged; };
+
+template<typename Iterator, typename Function>
+Function ul_for_each(Iterator first, Iterator last, Function function) {
+    if constexpr (ul_segmented_iterator<Iterator>) {
+        Iterator::visit_segments(first, last, [&function](auto from, auto to) {
+            for (; from != to; ++from) {
+                function(*from);
+            }
+            return to;
+        });
+        return function;
+    } else {
+        return std::for_each(first, last, std::move(function));
+    }
+}
+
+template<typename Iterator, typename Value>
+Iterator ul_find(Iterator first, Iterator last, const Value& value) {
+    if constexpr (ul_segmented_iterator<Iterator>) {
+        return Iterator::visit_segments(first, last, [&value](auto from, auto to) {
+            return std::find(from, to, value);
+        });
+    } else {
+        return std::find(first, last, value);
+    }
+}
+
+template<typename Iterator, typename Value>
+typename std::iterator_traits<Iterator>::difference_type ul_count(Iterator first, Iterator last, const Value& value) {
+    if constexpr (ul_segmented_iterator<Iterator>) {
+        typename std::iterator_traits<Iterator>::difference_type result = 0;
+        Iterator::visit_segments(first, last, [&value, &result](auto from, auto to) {
+            result += std::count(from, to, value);
+            return to;
+        });
+        return result;
+    } else {
+        return std::count(first, last, value);
+    }
+}
+
+template<typename Iterator, typename Value>
+Value ul_accumulate(Iterator first, Iterator last, Value init) {
+    if constexpr (ul_segmented_iterator<Iterator>) {
+        Iterator::visit_segments(first, last, [&init](auto from, auto to) {
+            init = std::accumulate(from, to, std::move(init));
+            return to;
+        });
+        return init;
+    } else {
+        return std::accumulate(first, last, std::move(init));
+    }
+}
+
+template<typename Iterator, typename OutputIterator>
+OutputIterator ul_copy(Iterator first, Iterator last, OutputIterator out) {
+    if constexpr (ul_segmented_iterator<Iterator>) {
+        Iterator::visit_segments(first, last, [&out](auto from, auto to) {
+            out = std::copy(from, to, out);
+            return to;
+        });
+        return out;
+    } else {
+        return std::copy(first, last, out);
+    }
+}
+
+template<typename Iterator, typename Value>
+void ul_fill(Iterator first, Iterator last, const Value& value) {
+    if constexpr (ul_segmented_iterator<Iterator>) {
+        Iterator::visit_segments(first, last, [&value](auto from, auto to) {
+            std::fill(from, to, value);
+            return to;
+        });
+    } else {
+        std::fill(first, last, value);
+    }
+}
+
+template<typename Iterator, typename OutputIterator, typename Operation>
+OutputIterator ul_transform(Iterator first, Iterator last, OutputIterator out, Operation operation) {
+    if constexpr (ul_segmented_iterator<Iterator>) {
+        Iterator::visit_segments(first, last, [&out, &operation](auto from, auto to) {
+            out = std::transform(from, to, out, operation);
+            return to;
+        });
+        return out;
+    } else {
+        return std::transform(first, last, out, std::move(operation));
+    }
+}
@@ -0,0 +1,366 @@
+#pragma once
+#include "unrolled_list.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+/*
+    Work-stealing pool: every worker owns a deque, takes work from its back and,
+    when it runs dry, steals from the front of the others. run() is fork-join and
+    the calling thread executes tasks while it waits, so nested run() calls from
+    inside a task cannot deadlock.
+*/
+class ul_thread_pool {
+public:
+
+    explicit ul_thread_pool(const size_t threads = std::max<size_t>(std::thread::hardware_concurrency(), 1)) {
+        queues_.reserve(threads + 1);
+        for (size_t i = 0; i <= threads; ++i) {
+            queues_.push_back(std::make_unique<worker_queue>());
+        }
+        threads_.reserve(threads);
+        for (size_t i = 1; i <= threads; ++i) {
+            threads_.emplace_back([this, i] { worker_loop(i); });
+        }
+    }
+
+    ul_thread_pool(const ul_thread_pool&) = delete;
+    ul_thread_pool& operator=(const ul_thread_pool&) = delete;
+
+    ~ul_thread_pool() {
+        {
+            std::lock_guard lock(sleep_mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    static ul_thread_pool& instance() {
+        static ul_thread_pool pool;
+        return pool;
+    }
+
+    // Worker threads plus the thread calling run().
+    size_t concurrency() const noexcept {
+        return threads_.size() + 1;
+    }
+
+    // Runs task(0), ..., task(count - 1) and returns once all of them finished.
+    // The first exception thrown by a task is rethrown here.
+    template<typename Task>
+    void run(const size_t count, Task&& task) {
+        std::atomic<size_t> remaining = count;
+        std::exception_ptr error;
+        std::mutex error_mutex;
+
+        const size_t first_queue = next_queue_.fetch_add(1, std::memory_order_relaxed);
+        for (size_t i = 0; i < count; ++i) {
+            worker_queue& queue = *queues_[(first_queue + i) % queues_.size()];
+            std::lock_guard lock(queue.mutex);
+            queue.tasks.emplace_back([&, i] {
+                try {
+                    task(i);
+                } catch (...) {
+                    std::lock_guard error_lock(error_mutex);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+                remaining.fetch_sub(1, std::memory_order_release);
+            });
+        }
+        {
+            std::lock_guard lock(sleep_mutex_);
+            pending_ += count;
+        }
+        wake_.notify_all();
+
+        while (remaining.load(std::memory_order_acquire) != 0) {
+            if (!run_one(0)) {
+                std::this_thread::yield();
+            }
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+
+    struct worker_queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    bool run_one(const size_t own) {
+        std::function<void()> task;
+        for (size_t i = 0; i < queues_.size() && !task; ++i) {
+            worker_queue& queue = *queues_[(own + i) % queues_.size()];
+            std::lock_guard lock(queue.mutex);
+            if (queue.tasks.empty()) {
+                continue;
+            }
+            if (i == 0) {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            } else {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+        }
+        if (!task) {
+            return false;
+        }
+        {
+            std::lock_guard lock(sleep_mutex_);
+            --pending_;
+        }
+        task();
+        return true;
+    }
+
+    void worker_loop(const size_t own) {
+        while (true) {
+            if (run_one(own)) {
+                continue;
+            }
+            std::unique_lock lock(sleep_mutex_);
+            wake_.wait(lock, [this] { return stopping_ || pending_ != 0; });
+            if (stopping_) {
+                return;
+            }
+        }
+    }
+
+    // queues_[0] is fed to the calling threads, queues_[i] belongs to threads_[i - 1]
+    std::vector<std::unique_ptr<worker_queue>> queues_;
+    std::vector<std::thread> threads_;
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    size_t pending_ = 0;
+    bool stopping_ = false;
+    std::atomic<size_t> next_queue_ = 0;
+};
+
+// Execution policy for the parallel ul_* overloads, e.g. ul_for_each(ul_par, first, last, f)
+// or ul_sort(ul_par.on(pool), list.begin(), list.end()).
+struct ul_parallel_policy {
+    ul_thread_pool* pool = nullptr;
+    size_t chunks_per_thread = 4;
+
+    ul_parallel_policy on(ul_thread_pool& other) const {
+        return {&other, chunks_per_thread};
+    }
+
+    ul_thread_pool& get_pool() const {
+        return pool ? *pool : ul_thread_pool::instance();
+    }
+};
+
+inline constexpr ul_parallel_policy ul_par{};
+
+template<typename Iterator>
+concept ul_chunkable_iterator = (ul_segmented_iterator<Iterator> && !ul_paged_segments<Iterator>)
+    || std::random_access_iterator<Iterator>;
+
+template<typename Iterator>
+struct ul_chunks {
+    std::vector<Iterator> bounds;
+    std::vector<size_t> offsets;
+    size_t total = 0;
+
+    size_t count() const noexcept {
+        return bounds.size() - 1;
+    }
+};
+
+// Cuts [first, last) into at most parts runs of nearly equal element count. For
+// unrolled_list the cut points are found from the node sizes, one pass over the nodes.
+template<ul_chunkable_iterator Iterator>
+ul_chunks<Iterator> ul_split_chunks(Iterator first, Iterator last, size_t parts) {
+    ul_chunks<Iterator> chunks;
+    if constexpr (ul_segmented_iterator<Iterator>) {
+        Iterator::visit_segments(first, last, [&chunks](auto from, auto to) {
+            chunks.total += to - from;
+            return to;
+        });
+    } else {
+        chunks.total = last - first;
+    }
+    parts = std::min(parts, chunks.total);
+
+    chunks.bounds.push_back(first);
+    chunks.offsets.push_back(0);
+    for (size_t k = 1; k < parts; ++k) {
+        const size_t target = chunks.total * k / parts;
+        if constexpr (ul_segmented_iterator<Iterator>) {
+            size_t remaining = target - chunks.offsets.back();
+            first = Iterator::visit_segments(first, last, [&remaining](auto from, auto to) {
+                if (static_cast<size_t>(to - from) > remaining) {
+                    return from + remaining;
+                }
+                remaining -= to - from;
+                return to;
+            });
+        } else {
+            first = chunks.bounds.front() + target;
+        }
+        chunks.bounds.push_back(first);
+        chunks.offsets.push_back(target);
+    }
+    if (parts != 0) {
+        chunks.bounds.push_back(last);
+        chunks.offsets.push_back(chunks.total);
+    }
+    return chunks;
+}
+
+template<typename Iterator>
+ul_chunks<Iterator> ul_split_chunks(const ul_parallel_policy& policy, Iterator first, Iterator last) {
+    return ul_split_chunks(first, last, policy.get_pool().concurrency() * policy.chunks_per_thread);
+}
+
+template<ul_chunkable_iterator Iterator, typename Function>
+void ul_for_each(const ul_parallel_policy& policy, Iterator first, Iterator last, Function function) {
+    const auto chunks = ul_split_chunks(policy, first, last);
+    policy.get_pool().run(chunks.count(), [&](const size_t i) {
+        ul_for_each(chunks.bounds[i], chunks.bounds[i + 1], function);
+    });
+}
+
+template<ul_chunkable_iterator Iterator, typename Predicate>
+typename std::iterator_traits<Iterator>::difference_type ul_count_if(
+    const ul_parallel_policy& policy, Iterator first, Iterator last, Predicate predicate) {
+    using difference_type = typename std::iterator_traits<Iterator>::difference_type;
+    const auto chunks = ul_split_chunks(policy, first, last);
+    std::vector<difference_type> counts(chunks.count());
+    policy.get_pool().run(chunks.count(), [&](const size_t i) {
+        difference_type result = 0;
+        ul_for_each(chunks.bounds[i], chunks.bounds[i + 1], [&result, &predicate](const auto& value) {
+            result += predicate(value) ? 1 : 0;
+        });
+        counts[i] = result;
+    });
+    return std::accumulate(counts.begin(), counts.end(), difference_type{0});
+}
+
+// Chunks after the leftmost one with a match are skipped once that match is known.
+template<ul_chunkable_iterator Iterator, typename Predicate>
+Iterator ul_find_if(const ul_parallel_policy& policy, Iterator first, Iterator last, Predicate predicate) {
+    const auto chunks = ul_split_chunks(policy, first, last);
+    std::vector<Iterator> found(chunks.bounds.begin() + 1, chunks.bounds.end());
+    std::atomic<size_t> leftmost = chunks.count();
+    policy.get_pool().run(chunks.count(), [&](const size_t i) {
+        if (leftmost.load(std::memory_order_relaxed) < i) {
+            return;
+        }
+        if constexpr (ul_segmented_iterator<Iterator>) {
+            found[i] = Iterator::visit_segments(chunks.bounds[i], chunks.bounds[i + 1], [&](auto from, auto to) {
+                return leftmost.load(std::memory_order_relaxed) < i ? to : std::find_if(from, to, predicate);
+            });
+        } else {
+            found[i] = std::find_if(chunks.bounds[i], chunks.bounds[i + 1], predicate);
+        }
+        if (found[i] != chunks.bounds[i + 1]) {
+            size_t current = leftmost.load(std::memory_order_relaxed);
+            while (i < current && !leftmost.compare_exchange_weak(current, i, std::memory_order_relaxed)) {
+            }
+        }
+    });
+    const size_t chunk = leftmost.load();
+    return chunk == chunks.count() ? last : found[chunk];
+}
+
+// Partial results are combined in chunk order, so op only has to be associative.
+template<ul_chunkable_iterator Iterator, typename Value, typename Operation = std::plus<>>
+Value ul_reduce(const ul_parallel_policy& policy, Iterator first, Iterator last, Value init,
+                Operation operation = Operation()) {
+    const auto chunks = ul_split_chunks(policy, first, last);
+    std::vector<std::optional<Value>> partials(chunks.count());
+    policy.get_pool().run(chunks.count(), [&](const size_t i) {
+        std::optional<Value>& partial = partials[i];
+        auto fold = [&partial, &operation](auto from, auto to) {
+            if (!partial) {
+                partial.emplace(*from++);
+            }
+            partial = std::accumulate(from, to, std::move(*partial), operation);
+            return to;
+        };
+        if constexpr (ul_segmented_iterator<Iterator>) {
+            Iterator::visit_segments(chunks.bounds[i], chunks.bounds[i + 1], fold);
+        } else {
+            fold(chunks.bounds[i], chunks.bounds[i + 1]);
+        }
+    });
+    for (auto& partial : partials) {
+        init = operation(std::move(init), std::move(*partial));
+    }
+    return init;
+}
+
+// out has to be random access or another unrolled_list iterator; the output chunk
+// starts are found by advancing out by the input chunk sizes.
+template<ul_chunkable_iterator Iterator, ul_chunkable_iterator OutputIterator, typename Operation>
+OutputIterator ul_transform(const ul_parallel_policy& policy, Iterator first, Iterator last,
+                            OutputIterator out, Operation operation) {
+    const auto chunks = ul_split_chunks(policy, first, last);
+    std::vector<OutputIterator> outputs{out};
+    for (size_t i = 0; i < chunks.count(); ++i) {
+        outputs.push_back(outputs.back() + (chunks.offsets[i + 1] - chunks.offsets[i]));
+    }
+    policy.get_pool().run(chunks.count(), [&](const size_t i) {
+        ul_transform(chunks.bounds[i], chunks.bounds[i + 1], outputs[i], operation);
+    });
+    return outputs.back();
+}
+
+/*
+    Elements are moved into a buffer, chunks of it are sorted in parallel and merged
+    pairwise (every merge round in parallel), then moved back chunk by chunk.
+*/
+template<ul_chunkable_iterator Iterator, typename Compare = std::less<>>
+void ul_sort(const ul_parallel_policy& policy, Iterator first, Iterator last, Compare compare = Compare()) {
+    using value_type = typename std::iterator_traits<Iterator>::value_type;
+    const auto chunks = ul_split_chunks(policy, first, last);
+    ul_thread_pool& pool = policy.get_pool();
+
+    std::vector<value_type> buffer;
+    buffer.reserve(chunks.total);
+    ul_for_each(first, last, [&buffer](value_type& value) {
+        buffer.push_back(std::move(value));
+    });
+
+    auto run_at = [&buffer, &chunks](const size_t chunk) {
+        return buffer.begin() + chunks.offsets[chunk];
+    };
+    pool.run(chunks.count(), [&](const size_t i) {
+        std::sort(run_at(i), run_at(i + 1), compare);
+    });
+    for (size_t width = 1; width < chunks.count(); width *= 2) {
+        const size_t merges = (chunks.count() + 2 * width - 1) / (2 * width);
+        pool.run(merges, [&](const size_t i) {
+            const size_t from = 2 * width * i;
+            const size_t middle = std::min(from + width, chunks.count());
+            const size_t to = std::min(from + 2 * width, chunks.count());
+            std::inplace_merge(run_at(from), run_at(middle), run_at(to), compare);
+        });
+    }
+
+    pool.run(chunks.count(), [&](const size_t i) {
+        auto source = std::make_move_iterator(run_at(i));
+        ul_for_each(chunks.bounds[i], chunks.bounds[i + 1], [&source](value_type& value) {
+            value = *source++;
+        });
+    });
+}
@@ -0,0 +1,270 @@
+#pragma once
+#include "unrolled_list.h"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <ios>
+#include <iterator>
+#include <new>
+#include <ranges>
+#include <span>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+    Read-only view of a file written by unrolled_list<T, ...>::save, mapped with mmap.
+    Nothing is deserialized: iterators and segments() point straight into the mapped
+    pages, one segment per saved node, and stepping to the next record needs only its
+    node_size. The constructor checks the header and walks the record sizes once, so a
+    damaged file is reported there rather than read out of bounds. POSIX only.
+*/
+template<typename T>
+class unrolled_list_view {
+    static_assert(std::is_trivially_copyable_v<T>, "unrolled_list_view maps elements as raw bytes");
+
+    static constexpr size_t alignment = ul_file_alignment<T>;
+    static constexpr size_t first_record = ul_file_round_up(sizeof(ul_file_header), alignment);
+
+    static std::uint64_t record_size(const std::byte* record) noexcept {
+        std::uint64_t node_size;
+        std::memcpy(&node_size, record, sizeof(node_size));
+        return node_size;
+    }
+
+    static const T* record_data(const std::byte* record) noexcept {
+        return std::launder(reinterpret_cast<const T*>(record + ul_file_round_up(sizeof(std::uint64_t), alignment)));
+    }
+
+    static const std::byte* next_record(const std::byte* record) noexcept {
+        return record + ul_file_round_up(sizeof(std::uint64_t), alignment)
+            + ul_file_round_up(static_cast<size_t>(record_size(record)) * sizeof(T), alignment);
+    }
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = const T&;
+    using const_reference = const T&;
+
+    class const_iterator {
+    public:
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using reference = const T&;
+        using pointer = const T*;
+        using iterator_category = std::forward_iterator_tag;
+
+        const_iterator() = default;
+
+        reference operator*() const {
+            return record_data(record_)[index_];
+        }
+
+        pointer operator->() const {
+            return record_data(record_) + index_;
+        }
+
+        const_iterator& operator++() {
+            if (++index_ == record_size(record_)) {
+                record_ = next_record(record_);
+                index_ = 0;
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator temp = *this;
+            ++(*this);
+            return temp;
+        }
+
+        bool operator==(const const_iterator& other) const = default;
+
+    private:
+        friend class unrolled_list_view;
+
+        const_iterator(const std::byte* record, const size_t index) : record_(record), index_(index) {}
+
+        const std::byte* record_ = nullptr;
+        size_t index_ = 0;
+    };
+
+    using iterator = const_iterator;
+
+    // Walks the file record by record; each record is one contiguous std::span.
+    struct const_segment_iterator {
+        using value_type = std::span<const T>;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+
+        const std::byte* record = nullptr;
+
+        value_type operator*() const {
+            return value_type(record_data(record), static_cast<size_t>(record_size(record)));
+        }
+
+        const_segment_iterator& operator++() {
+            record = next_record(record);
+            return *this;
+        }
+
+        const_segment_iterator operator++(int) {
+            const_segment_iterator temp = *this;
+            ++(*this);
+            return temp;
+        }
+
+        bool operator==(const const_segment_iterator& other) const = default;
+    };
+
+    unrolled_list_view() = default;
+
+    // Throws std::system_error if the file cannot be mapped and std::ios_base::failure if
+    // it was not saved from a list of T or is damaged.
+    explicit unrolled_list_view(const std::filesystem::path& path) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "unrolled_list_view: open");
+        }
+        struct stat status;
+        if (::fstat(fd, &status) != 0) {
+            const int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "unrolled_list_view: fstat");
+        }
+        length_ = static_cast<size_t>(status.st_size);
+        if (length_ < first_record) {
+            ::close(fd);
+            throw std::ios_base::failure("unrolled_list_view: not a file of this element type");
+        }
+        void* mapping = ::mmap(nullptr, length_, PROT_READ, MAP_PRIVATE, fd, 0);
+        const int error = errno;
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            throw std::system_error(error, std::generic_category(), "unrolled_list_view: mmap");
+        }
+        mapping_ = static_cast<const std::byte*>(mapping);
+        try {
+            validate();
+        } catch (...) {
+            unmap();
+            throw;
+        }
+    }
+
+    unrolled_list_view(const unrolled_list_view&) = delete;
+    unrolled_list_view& operator=(const unrolled_list_view&) = delete;
+
+    unrolled_list_view(unrolled_list_view&& other) noexcept
+    : mapping_(std::exchange(other.mapping_, nullptr)), length_(std::exchange(other.length_, 0))
+    , end_(std::exchange(other.end_, nullptr)), size_(std::exchange(other.size_, 0)) {
+    }
+
+    unrolled_list_view& operator=(unrolled_list_view&& other) noexcept {
+        unrolled_list_view(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    ~unrolled_list_view() {
+        unmap();
+    }
+
+    void swap(unrolled_list_view& other) noexcept {
+        std::swap(mapping_, other.mapping_);
+        std::swap(length_, other.length_);
+        std::swap(end_, other.end_);
+        std::swap(size_, other.size_);
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(mapping_ ? mapping_ + first_record : nullptr, 0);
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(end_, 0);
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    std::ranges::subrange<const_segment_iterator> segments() const noexcept {
+        return {const_segment_iterator{begin().record_}, const_segment_iterator{end_}};
+    }
+
+    size_t size() const noexcept {
+        return size_;
+    }
+
+    bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+    const T& front() const {
+        return *begin();
+    }
+
+private:
+
+    // Checks the header, and that the padded records are non-empty, fit the file and add up to its size.
+    void validate() {
+        ul_file_header header;
+        std::memcpy(&header, mapping_, sizeof(header));
+        if (!header.holds<T>()) {
+            throw std::ios_base::failure("unrolled_list_view: not a file of this element type");
+        }
+        const std::byte* record = mapping_ + first_record;
+        const std::byte* const limit = mapping_ + length_;
+        std::uint64_t elements = 0;
+        for (std::uint64_t i = 0; i < header.node_count; ++i) {
+            const size_t room = static_cast<size_t>(limit - record);
+            if (room < sizeof(std::uint64_t)) {
+                throw std::ios_base::failure("unrolled_list_view: truncated file");
+            }
+            const std::uint64_t node_size = record_size(record);
+            if (node_size == 0 || node_size > (room - sizeof(std::uint64_t)) / sizeof(T)) {
+                throw std::ios_base::failure("unrolled_list_view: corrupt file");
+            }
+            // next_record skips the padding too, so the padded length has to fit
+            const size_t bytes = ul_file_round_up(sizeof(std::uint64_t), alignment)
+                + ul_file_round_up(static_cast<size_t>(node_size) * sizeof(T), alignment);
+            if (bytes > room) {
+                throw std::ios_base::failure("unrolled_list_view: truncated file");
+            }
+            elements += node_size;
+            record = next_record(record);
+        }
+        if (elements != header.size) {
+            throw std::ios_base::failure("unrolled_list_view: corrupt file");
+        }
+        end_ = record;
+        size_ = static_cast<size_t>(header.size);
+    }
+
+    void unmap() noexcept {
+        if (mapping_) {
+            ::munmap(const_cast<std::byte*>(mapping_), length_);
+            mapping_ = nullptr;
+        }
+    }
+
+    const std::byte* mapping_ = nullptr;
+    size_t length_ = 0;
+    const std::byte* end_ = nullptr;
+    size_t size_ = 0;
+};
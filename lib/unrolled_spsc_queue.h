@@ -0,0 +1,199 @@
+#pragma once
+#include "unrolled_list.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+/*
+    Unbounded single-producer/single-consumer queue over a singly linked chain of
+    unrolled nodes, without locks and, once warmed up, without allocation.
+
+    The producer constructs elements in the tail node and publishes each one with a
+    release store of the node's size; a new node is linked with a release store of next.
+    The consumer reloads a node's size (acquire) only after it has popped every element
+    it saw last time, and destroys elements as it pops them. The nodes it has left
+    behind lie between first_ and head_: the producer takes them back for reuse, after
+    an acquire load of head_, instead of allocating.
+
+    push/emplace must be called from one thread only, and try_pop/consume_all/empty from
+    one other thread only.
+*/
+template<typename T, size_t NodeMaxSize = 64, typename Allocator = std::allocator<T>>
+class unrolled_spsc_queue {
+    static_assert(NodeMaxSize > 0, "unrolled_spsc_queue needs room for at least one element per node");
+
+    struct Node {
+        std::atomic<size_t> node_size = 0;
+        std::atomic<Node*> next = nullptr;
+        alignas(T) unsigned char storage[sizeof(T) * NodeMaxSize];
+
+        T* slots() noexcept {
+            return std::launder(reinterpret_cast<T*>(storage));
+        }
+    };
+
+    using t_allocator_traits = std::allocator_traits<Allocator>;
+    using node_allocator = typename t_allocator_traits::template rebind_alloc<Node>;
+    using node_allocator_traits = std::allocator_traits<node_allocator>;
+
+public:
+    using value_type = T;
+    using allocator_type = Allocator;
+
+    explicit unrolled_spsc_queue(const allocator_type& alloc = allocator_type())
+    : t_alloc_(alloc), node_alloc_(alloc) {
+        Node* node = allocate_node();
+        tail_ = node;
+        first_ = node;
+        head_seen_ = node;
+        head_.store(node, std::memory_order_relaxed);
+        head_node_ = node;
+    }
+
+    unrolled_spsc_queue(const unrolled_spsc_queue&) = delete;
+    unrolled_spsc_queue& operator=(const unrolled_spsc_queue&) = delete;
+
+    ~unrolled_spsc_queue() {
+        Node* node = head_node_;
+        size_t index = read_index_;
+        while (node) {
+            const size_t node_size = node->node_size.load(std::memory_order_acquire);
+            for (; index < node_size; ++index) {
+                t_allocator_traits::destroy(t_alloc_, node->slots() + index);
+            }
+            node = node->next.load(std::memory_order_acquire);
+            index = 0;
+        }
+        for (node = first_; node;) {
+            Node* next = node->next.load(std::memory_order_relaxed);
+            deallocate_node(node);
+            node = next;
+        }
+    }
+
+    // Producer side.
+
+    void push(const T& value) {
+        emplace(value);
+    }
+
+    void push(T&& value) {
+        emplace(std::move(value));
+    }
+
+    // Strong guarantee: if the construction throws, nothing is published.
+    template<typename... Args>
+    void emplace(Args&&... args) {
+        if (tail_size_ == NodeMaxSize) {
+            Node* node = take_node();
+            tail_->next.store(node, std::memory_order_release);
+            tail_ = node;
+            tail_size_ = 0;
+        }
+        t_allocator_traits::construct(t_alloc_, tail_->slots() + tail_size_, std::forward<Args>(args)...);
+        ++tail_size_;
+        tail_->node_size.store(tail_size_, std::memory_order_release);
+    }
+
+    // Consumer side.
+
+    bool try_pop(T& value) {
+        if (!has_visible()) {
+            return false;
+        }
+        T* slot = head_node_->slots() + read_index_;
+        value = std::move(*slot);
+        t_allocator_traits::destroy(t_alloc_, slot);
+        ++read_index_;
+        return true;
+    }
+
+    // Hands every element published so far to function(T&&), node block by node block,
+    // with one acquire load per node. Returns the number of elements consumed.
+    template<typename Function>
+    size_t consume_all(Function function) {
+        size_t consumed = 0;
+        while (has_visible()) {
+            T* data = head_node_->slots();
+            for (; read_index_ < seen_size_; ++read_index_, ++consumed) {
+                function(std::move(data[read_index_]));
+                t_allocator_traits::destroy(t_alloc_, data + read_index_);
+            }
+        }
+        return consumed;
+    }
+
+    bool empty() {
+        return !has_visible();
+    }
+
+private:
+
+    // Makes sure head_node_ has an unread published element if there is one, stepping
+    // to the next node once the current one is exhausted.
+    bool has_visible() {
+        if (read_index_ != seen_size_) {
+            return true;
+        }
+        seen_size_ = head_node_->node_size.load(std::memory_order_acquire);
+        if (read_index_ != seen_size_) {
+            return true;
+        }
+        if (read_index_ != NodeMaxSize) {
+            return false;
+        }
+        Node* next = head_node_->next.load(std::memory_order_acquire);
+        if (next == nullptr) {
+            return false;
+        }
+        head_node_ = next;
+        read_index_ = 0;
+        head_.store(next, std::memory_order_release);
+        seen_size_ = next->node_size.load(std::memory_order_acquire);
+        return seen_size_ != 0;
+    }
+
+    // A node the consumer has left behind, or a fresh one.
+    Node* take_node() {
+        if (first_ == head_seen_) {
+            head_seen_ = head_.load(std::memory_order_acquire);
+        }
+        if (first_ == head_seen_) {
+            return allocate_node();
+        }
+        Node* node = first_;
+        first_ = node->next.load(std::memory_order_relaxed);
+        node->node_size.store(0, std::memory_order_relaxed);
+        node->next.store(nullptr, std::memory_order_relaxed);
+        return node;
+    }
+
+    Node* allocate_node() {
+        Node* node = node_allocator_traits::allocate(node_alloc_, 1);
+        node_allocator_traits::construct(node_alloc_, node);
+        return node;
+    }
+
+    void deallocate_node(Node* node) noexcept {
+        node_allocator_traits::destroy(node_alloc_, node);
+        node_allocator_traits::deallocate(node_alloc_, node, 1);
+    }
+
+    [[no_unique_address]] allocator_type t_alloc_;
+    [[no_unique_address]] node_allocator node_alloc_;
+
+    // producer: tail node, its element count, and the recyclable nodes [first_, head_seen_)
+    alignas(ul_cache_line_size) Node* tail_;
+    size_t tail_size_ = 0;
+    Node* first_;
+    Node* head_seen_;
+
+    // consumer: the node it reads, published to the producer through head_
+    alignas(ul_cache_line_size) std::atomic<Node*> head_;
+    Node* head_node_;
+    size_t read_index_ = 0;
+    size_t seen_size_ = 0;
+};
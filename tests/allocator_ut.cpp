@@ -3,6 +3,10 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <memory_resource>
+#include <string>
+#include <vector>
+
 class NodeTag {};
 
 class SomeObj2 {
@@ -91,7 +95,8 @@ public:
     Ожидается, что будет:
         1. 3 аллокации Node
         2. 3 создания Node
-        3. 11 конструкторов и деструкторов у SomeObj2
+        3. Ни одной отдельной аллокации под элементы: они хранятся внутри Node
+        4. 11 конструкторов и деструкторов у SomeObj2
 */
 TEST_F(WorkWithAllocatorTest, simplePushBack) {
     TestAllocator<SomeObj2> allocator;
@@ -103,8 +108,249 @@ TEST_F(WorkWithAllocatorTest, simplePushBack) {
     ASSERT_EQ(TestAllocator<NodeTag>::AllocationCount, 3);
     ASSERT_EQ(TestAllocator<NodeTag>::ElementsAllocated, 3);
 
-    ASSERT_EQ(TestAllocator<SomeObj2>::AllocationCount, 3);
+    ASSERT_EQ(TestAllocator<SomeObj2>::AllocationCount, 0);
 
     ASSERT_EQ(SomeObj2::ConstructorCalled, 11);
     ASSERT_EQ(SomeObj2::DestructorCalled, 11);
 }
+
+/*
+    Очередь: push_back/pop_front в цикле при NodeMaxSize = 4.
+    Ожидается, что после прогрева ноды переиспользуются из кэша и новых аллокаций нет
+*/
+TEST_F(WorkWithAllocatorTest, nodeCacheChurn) {
+    unrolled_list<SomeObj2, 4, TestAllocator<SomeObj2>> list;
+    for (int i = 0; i < 8; ++i) {
+        list.push_back(SomeObj2{});
+    }
+    const int warm_allocations = TestAllocator<NodeTag>::AllocationCount;
+
+    for (int i = 0; i < 1000; ++i) {
+        list.push_back(SomeObj2{});
+        list.pop_front();
+    }
+
+    ASSERT_EQ(TestAllocator<NodeTag>::AllocationCount - warm_allocations, 1);
+    ASSERT_EQ(list.size(), 8);
+}
+
+TEST_F(WorkWithAllocatorTest, reserveNodesAndShrink) {
+    unrolled_list<SomeObj2, 4, TestAllocator<SomeObj2>> list;
+    list.reserve_nodes(3);
+    ASSERT_EQ(TestAllocator<NodeTag>::AllocationCount, 3);
+    ASSERT_EQ(list.cached_nodes(), 3);
+
+    for (int i = 0; i < 12; ++i) {
+        list.push_back(SomeObj2{});
+    }
+    ASSERT_EQ(TestAllocator<NodeTag>::AllocationCount, 3);
+    ASSERT_EQ(list.cached_nodes(), 0);
+
+    list.clear();
+    ASSERT_EQ(list.cached_nodes(), 3);
+    list.shrink_to_fit();
+    ASSERT_EQ(list.cached_nodes(), 0);
+}
+
+/*
+    Вставка 1000 элементов в середину списка из 10 элементов при NodeMaxSize = 10.
+    Ожидается, что новые элементы будут уложены в полностью заполненные ноды:
+    100 нод под вставку и одна под отрезанный хвост исходной ноды
+*/
+TEST_F(WorkWithAllocatorTest, bulkInsertAllocations) {
+    unrolled_list<SomeObj2, 10, TestAllocator<SomeObj2>> list(10, SomeObj2{});
+    std::vector<SomeObj2> batch(1000);
+    const int initial_allocations = TestAllocator<NodeTag>::AllocationCount;
+
+    list.insert(std::next(list.begin(), 5), batch.begin(), batch.end());
+
+    ASSERT_EQ(TestAllocator<NodeTag>::AllocationCount - initial_allocations, 101);
+    ASSERT_EQ(list.size(), 1010);
+}
+
+/*
+    Копия повторяет ноды источника, а копирующее присваивание
+    переиспользует уже имеющиеся ноды и аллоцирует только недостающие
+*/
+TEST_F(WorkWithAllocatorTest, copyReusesNodes) {
+    unrolled_list<SomeObj2, 4, TestAllocator<SomeObj2>> source(12, SomeObj2{});
+    ASSERT_EQ(TestAllocator<NodeTag>::AllocationCount, 3);
+
+    unrolled_list<SomeObj2, 4, TestAllocator<SomeObj2>> copy(source);
+    ASSERT_EQ(TestAllocator<NodeTag>::AllocationCount, 6);
+    ASSERT_EQ(copy.size(), 12);
+
+    unrolled_list<SomeObj2, 4, TestAllocator<SomeObj2>> longer(20, SomeObj2{});
+    const int allocations = TestAllocator<NodeTag>::AllocationCount;
+    longer = source;
+    ASSERT_EQ(TestAllocator<NodeTag>::AllocationCount, allocations);
+    ASSERT_EQ(longer.size(), 12);
+    ASSERT_EQ(longer.cached_nodes(), 2);
+
+    unrolled_list<SomeObj2, 4, TestAllocator<SomeObj2>> shorter(4, SomeObj2{});
+    shorter = longer;
+    ASSERT_EQ(TestAllocator<NodeTag>::AllocationCount, allocations + 3);
+    ASSERT_EQ(shorter.size(), 12);
+}
+
+class CountingArena : public std::pmr::monotonic_buffer_resource {
+public:
+    int Allocations = 0;
+    int Deallocations = 0;
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        ++Allocations;
+        return monotonic_buffer_resource::do_allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        ++Deallocations;
+        monotonic_buffer_resource::do_deallocate(p, bytes, alignment);
+    }
+};
+
+class CountingResource : public std::pmr::memory_resource {
+public:
+    int Allocations = 0;
+    int Deallocations = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        ++Allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        ++Deallocations;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+/*
+    Список на monotonic_buffer_resource с тривиально разрушаемыми элементами
+    при clear() и в деструкторе не обходит ноды и ничего не освобождает
+*/
+TEST(PmrAllocator, arenaSkipsDeallocation) {
+    CountingArena arena;
+    {
+        unrolled_list_pmr::unrolled_list<int, 8> list(&arena);
+        ASSERT_TRUE(list.releases_in_bulk());
+        for (int i = 0; i < 1000; ++i) {
+            list.push_back(i);
+        }
+        ASSERT_EQ(arena.Allocations, 125);
+
+        list.clear();
+        ASSERT_TRUE(list.empty());
+        ASSERT_EQ(list.begin(), list.end());
+        list.push_back(1);
+        ASSERT_EQ(list.front(), 1);
+    }
+    ASSERT_EQ(arena.Deallocations, 0);
+
+    unrolled_list_pmr::unrolled_list<std::pmr::string, 8> strings(&arena);
+    ASSERT_FALSE(strings.releases_in_bulk());
+}
+
+TEST(PmrAllocator, elementsUseListResource) {
+    CountingResource resource;
+    {
+        unrolled_list_pmr::unrolled_list<std::pmr::string, 4> list(&resource);
+        ASSERT_FALSE(list.releases_in_bulk());
+        for (int i = 0; i < 10; ++i) {
+            list.emplace_back(40, 'a' + i);
+        }
+        ASSERT_EQ(list.back().get_allocator().resource(), &resource);
+        ASSERT_EQ(resource.Allocations, 13);
+
+        // копия получает ресурс по умолчанию, присваивание сохраняет свой
+        auto copy = list;
+        ASSERT_EQ(copy.get_allocator().resource(), std::pmr::get_default_resource());
+        ASSERT_EQ(copy.front(), list.front());
+
+        unrolled_list_pmr::unrolled_list<std::pmr::string, 4> assigned(&resource);
+        assigned = copy;
+        ASSERT_EQ(assigned.get_allocator().resource(), &resource);
+        ASSERT_EQ(assigned.front().get_allocator().resource(), &resource);
+
+        unrolled_list_pmr::unrolled_list<std::pmr::string, 4> moved(&resource);
+        moved = std::move(copy);
+        ASSERT_EQ(moved.get_allocator().resource(), &resource);
+        ASSERT_EQ(moved.back(), list.back());
+    }
+    ASSERT_EQ(resource.Allocations, resource.Deallocations);
+}
+
+template<typename T>
+class PropagatingAllocator : public std::allocator<T> {
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    explicit PropagatingAllocator(int id = 0) : Id(id) {}
+
+    template<typename U>
+    PropagatingAllocator(const PropagatingAllocator<U>& other) : Id(other.Id) {}
+
+    template<typename U>
+    struct rebind {
+        using other = PropagatingAllocator<U>;
+    };
+
+    bool operator==(const PropagatingAllocator& other) const {
+        return Id == other.Id;
+    }
+
+    int Id;
+};
+
+TEST(PmrAllocator, propagationTraits) {
+    using list_type = unrolled_list<int, 4, PropagatingAllocator<int>>;
+    list_type first({1, 2, 3}, PropagatingAllocator<int>(1));
+    list_type second({4, 5, 6, 7, 8}, PropagatingAllocator<int>(2));
+
+    first.swap(second);
+    ASSERT_EQ(first.get_allocator().Id, 2);
+    ASSERT_EQ(second.get_allocator().Id, 1);
+    ASSERT_THAT(first, ::testing::ElementsAre(4, 5, 6, 7, 8));
+
+    list_type third(PropagatingAllocator<int>(3));
+    third = first;
+    ASSERT_EQ(third.get_allocator().Id, 2);
+    ASSERT_EQ(third, first);
+
+    list_type fourth(PropagatingAllocator<int>(4));
+    fourth = std::move(second);
+    ASSERT_EQ(fourth.get_allocator().Id, 1);
+    ASSERT_THAT(fourth, ::testing::ElementsAre(1, 2, 3));
+}
+
+/*
+    После reserve(n) вставка n элементов в конец не аллоцирует,
+    assign переиспользует имеющиеся ноды
+*/
+TEST_F(WorkWithAllocatorTest, reserveAndAssignDoNotAllocate) {
+    unrolled_list<SomeObj2, 4, TestAllocator<SomeObj2>> list(3, SomeObj2{});
+    list.reserve(30);
+    ASSERT_GE(list.capacity(), 30);
+    const int allocations = TestAllocator<NodeTag>::AllocationCount;
+    ASSERT_EQ(allocations, 8);
+
+    for (int i = 0; i < 27; ++i) {
+        list.push_back(SomeObj2{});
+    }
+    ASSERT_EQ(TestAllocator<NodeTag>::AllocationCount, allocations);
+
+    list.assign(10, SomeObj2{});
+    list.assign(30, SomeObj2{});
+    ASSERT_EQ(list.size(), 30);
+    ASSERT_EQ(TestAllocator<NodeTag>::AllocationCount, allocations);
+}
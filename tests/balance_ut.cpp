@@ -0,0 +1,114 @@
+#include <unrolled_list.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <list>
+#include <random>
+#include <string>
+
+template<typename T>
+class LiveNodesAllocator {
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    static inline int LiveAllocations = 0;
+
+    LiveNodesAllocator() = default;
+
+    template<typename U>
+    LiveNodesAllocator(const LiveNodesAllocator<U>&) {}
+
+    T* allocate(std::size_t n) {
+        ++LiveNodesAllocator<void>::LiveAllocations;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n) {
+        --LiveNodesAllocator<void>::LiveAllocations;
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    bool operator==(const LiveNodesAllocator&) const {
+        return true;
+    }
+};
+
+template<typename Balance>
+int LiveNodesAfterSparseErase() {
+    LiveNodesAllocator<void>::LiveAllocations = 0;
+    unrolled_list<int, 8, LiveNodesAllocator<int>, ul_no_index, Balance> list;
+    list.set_node_cache_limit(0);
+    for (int i = 0; i < 800; ++i) {
+        list.push_back(i);
+    }
+
+    auto it = list.begin();
+    for (int i = 0; i < 800; ++i) {
+        it = (i % 8 == 0) ? std::next(it) : list.erase(it);
+    }
+    EXPECT_EQ(list.size(), 100);
+    EXPECT_EQ(list.front(), 0);
+    EXPECT_EQ(list.back(), 792);
+    return LiveNodesAllocator<void>::LiveAllocations;
+}
+
+/*
+    Из 100 заполненных нод удаляются 7 из каждых 8 элементов.
+    Ленивая политика оставляет 100 нод по одному элементу,
+    половинная — держит ноды заполненными хотя бы наполовину
+*/
+TEST(BalancePolicy, mergesUnderfullNodes) {
+    ASSERT_EQ(LiveNodesAfterSparseErase<ul_lazy_balance>(), 100);
+    ASSERT_LE(LiveNodesAfterSparseErase<ul_half_balance>(), 100 / 4 + 1);
+}
+
+template<typename Balance>
+int LiveNodesAfterMiddleInserts() {
+    LiveNodesAllocator<void>::LiveAllocations = 0;
+    unrolled_list<int, 8, LiveNodesAllocator<int>, ul_no_index, Balance> list;
+    for (int i = 0; i < 8; ++i) {
+        list.push_back(i);
+    }
+    for (int i = 0; i < 4; ++i) {
+        list.insert(std::next(list.begin(), 2), -i);
+    }
+    EXPECT_THAT(list, ::testing::ElementsAre(0, 1, -3, -2, -1, 0, 2, 3, 4, 5, 6, 7));
+    return LiveNodesAllocator<void>::LiveAllocations;
+}
+
+/*
+    Вставка в заполненную ноду переносит половину элементов в новую ноду,
+    поэтому следующие вставки в ту же ноду не создают новых нод
+*/
+TEST(BalancePolicy, splitsFullNodeInHalf) {
+    ASSERT_EQ(LiveNodesAfterMiddleInserts<ul_lazy_balance>(), 5);
+    ASSERT_EQ(LiveNodesAfterMiddleInserts<ul_half_balance>(), 2);
+}
+
+TEST(BalancePolicy, randomOperationsMatchStdList) {
+    std::list<std::string> std_list;
+    unrolled_list<std::string, 5> unrolled_list;
+    std::mt19937 gen(7);
+
+    for (int step = 0; step < 3000; ++step) {
+        const size_t position = std_list.empty() ? 0 : gen() % std_list.size();
+        auto std_it = std::next(std_list.begin(), position);
+        auto unrolled_it = std::next(unrolled_list.begin(), position);
+        if (gen() % 3 != 0 || std_list.empty()) {
+            std_it = std_list.insert(std_it, std::to_string(step));
+            unrolled_it = unrolled_list.insert(unrolled_it, std::to_string(step));
+        } else {
+            std_it = std_list.erase(std_it);
+            unrolled_it = unrolled_list.erase(unrolled_it);
+        }
+        if (std_it == std_list.end()) {
+            ASSERT_EQ(unrolled_it, unrolled_list.end());
+        } else {
+            ASSERT_EQ(*unrolled_it, *std_it);
+        }
+    }
+
+    ASSERT_THAT(unrolled_list, ::testing::ElementsAreArray(std_list));
+}
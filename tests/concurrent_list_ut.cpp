@@ -0,0 +1,214 @@
+#include <concurrent_unrolled_list.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::atomic<long> LiveNodes = 0;
+
+template<typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    CountingAllocator() = default;
+
+    template<typename U>
+    CountingAllocator(const CountingAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        LiveNodes.fetch_add(1);
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) {
+        LiveNodes.fetch_sub(1);
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    bool operator==(const CountingAllocator&) const = default;
+};
+
+// The concurrent list has no iterators, so its contents are collected through for_each.
+template<typename List>
+std::vector<typename List::value_type> Collect(const List& list) {
+    std::vector<typename List::value_type> result;
+    list.for_each([&result](const auto& value) { result.push_back(value); });
+    return result;
+}
+
+}
+
+TEST(ConcurrentUnrolledList, matchesVectorSingleThreaded) {
+    concurrent_unrolled_list<std::string, 4> list;
+    std::vector<std::string> expected;
+    std::mt19937 gen(5);
+
+    for (int step = 0; step < 4000; ++step) {
+        const std::string value = std::to_string(step);
+        switch (gen() % 5) {
+            case 0:
+                list.push_back(value);
+                expected.push_back(value);
+                break;
+            case 1:
+                list.push_front(value);
+                expected.insert(expected.begin(), value);
+                break;
+            case 2: {
+                const size_t index = gen() % (expected.size() + 1);
+                ASSERT_TRUE(list.insert(index, value));
+                expected.insert(expected.begin() + index, value);
+                break;
+            }
+            case 3: {
+                const size_t index = gen() % (expected.size() + 1);
+                ASSERT_EQ(list.erase(index), index < expected.size());
+                if (index < expected.size()) {
+                    expected.erase(expected.begin() + index);
+                }
+                break;
+            }
+            default: {
+                const size_t index = gen() % (expected.size() + 1);
+                std::string read;
+                ASSERT_EQ(list.read(index, read), index < expected.size());
+                if (index < expected.size()) {
+                    ASSERT_EQ(read, expected[index]);
+                }
+            }
+        }
+        ASSERT_EQ(list.size(), expected.size());
+    }
+
+    ASSERT_EQ(Collect(list), expected);
+    ASSERT_FALSE(list.insert(expected.size() + 1, "x"));
+    ASSERT_TRUE(list.update(0, [](std::string& value) { value = "first"; }));
+    ASSERT_EQ(Collect(list).front(), "first");
+}
+
+/*
+    Несколько потоков добавляют в конец: элементы каждого потока
+    сохраняют свой порядок, ничего не теряется
+*/
+TEST(ConcurrentUnrolledList, concurrentPushBackKeepsPerThreadOrder) {
+    constexpr int threads = 4;
+    constexpr int per_thread = 20000;
+    concurrent_unrolled_list<int, 16> list;
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&list, t] {
+            for (int i = 0; i < per_thread; ++i) {
+                list.push_back(t * per_thread + i);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    const std::vector<int> values = Collect(list);
+    ASSERT_EQ(values.size(), threads * per_thread);
+    std::vector<int> last(threads, -1);
+    for (int value : values) {
+        const int thread = value / per_thread;
+        ASSERT_GT(value, last[thread]);
+        last[thread] = value;
+    }
+}
+
+TEST(ConcurrentUnrolledList, concurrentInsertEraseAndPush) {
+    constexpr int threads = 4;
+    constexpr int per_thread = 5000;
+    concurrent_unrolled_list<int, 8> list;
+    for (int i = 0; i < 100; ++i) {
+        list.push_back(-1 - i);
+    }
+
+    // позиция, выбранная по size(), может устареть: такие insert возвращают false
+    std::atomic<int> rejected = 0;
+    std::atomic<int> erased = 0;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&list, &rejected, &erased, t] {
+            std::mt19937 gen(t);
+            for (int i = 0; i < per_thread; ++i) {
+                const int value = t * per_thread + i;
+                switch (gen() % 4) {
+                    case 0:
+                        list.push_back(value);
+                        break;
+                    case 1:
+                        list.push_front(value);
+                        break;
+                    case 2:
+                        rejected += !list.insert(gen() % (list.size() + 1), value);
+                        break;
+                    default:
+                        rejected += !list.insert(gen() % (list.size() + 1), value);
+                        if (list.erase(gen() % (list.size() + 1))) {
+                            ++erased;
+                        }
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    const std::vector<int> values = Collect(list);
+    const std::set<int> unique(values.begin(), values.end());
+    ASSERT_EQ(unique.size(), values.size());
+    ASSERT_EQ(list.size(), values.size());
+    ASSERT_GE(*unique.begin(), -100);
+    ASSERT_LT(*unique.rbegin(), threads * per_thread);
+    ASSERT_EQ(values.size(), 100 + threads * per_thread - rejected - erased);
+}
+
+/*
+    Пока другие потоки непрерывно добавляют в конец, удаление из начала
+    освобождает опустевшие ноды, а не копит их до разрушения списка
+*/
+TEST(ConcurrentUnrolledList, removedNodesAreFreedUnderPushBackTraffic) {
+    constexpr int pushers = 3;
+    constexpr size_t node_size = 4;
+    LiveNodes = 0;
+    {
+        concurrent_unrolled_list<int, node_size, CountingAllocator<int>> list;
+        std::atomic<bool> stop = false;
+        std::vector<std::thread> workers;
+        for (int t = 0; t < pushers; ++t) {
+            workers.emplace_back([&list, &stop] {
+                while (!stop.load()) {
+                    list.push_back(1);
+                }
+            });
+        }
+
+        long max_excess = 0;
+        for (int i = 0; i < 200000; ++i) {
+            list.erase(0);
+            if (i % 1000 == 0) {
+                const long in_list = static_cast<long>((list.size() + node_size - 1) / node_size);
+                max_excess = std::max(max_excess, LiveNodes.load() - in_list);
+            }
+        }
+        stop = true;
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        // retired ноды ждут очередного прохода очистки (не больше 2 * 64 + 64),
+        // плюс ноды, добавленные между чтением size() и счётчика
+        ASSERT_LE(max_excess, 2 * 64 + 64 + 2 * pushers + 2);
+    }
+    ASSERT_EQ(LiveNodes.load(), 0);
+}
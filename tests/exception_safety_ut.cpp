@@ -16,6 +16,10 @@ public:
 
     SomeObj(SomeObj&&) {}
 
+    SomeObj& operator=(SomeObj&&) {
+        return *this;
+    }
+
     SomeObj(const SomeObj&) {
         ++CopiesCount;
         if (CopiesCount == 3) {
@@ -190,3 +194,45 @@ TEST_F(ExceptionSafetyTest, failesAtPushFront) {
     ASSERT_EQ(unrolled_list.begin()->Name, std::string("second"));
     ASSERT_EQ((++unrolled_list.begin())->Name, std::string("first"));
 }
+
+/*
+    Вставка в полную ноду единичного размера переносит её элемент в новую ноду.
+    Если конструктор вставляемого элемента бросает исключение,
+    опустевшая нода не должна остаться в списке.
+*/
+TEST_F(ExceptionSafetyTest, failesAtInsertIntoSingleElementNode) {
+    unrolled_list<BadOrGood, 1> unrolled_list;
+    unrolled_list.push_back(Good{.Name = "seven"});
+
+    ASSERT_ANY_THROW(unrolled_list.emplace(unrolled_list.cbegin(), Bad{}));
+
+    ASSERT_EQ(unrolled_list.size(), 1);
+    ASSERT_EQ(std::distance(unrolled_list.begin(), unrolled_list.end()), 1);
+    ASSERT_EQ(unrolled_list.begin()->Name, std::string("seven"));
+
+    unrolled_list.emplace(unrolled_list.cbegin(), Good{.Name = "six"});
+    ASSERT_EQ(std::distance(unrolled_list.begin(), unrolled_list.end()), 2);
+    ASSERT_EQ(unrolled_list.begin()->Name, std::string("six"));
+}
+
+/*
+    Вставка диапазона, который помещается в ноду, копирует элементы по одному.
+    SomeObj бросает исключение на третьем копировании.
+
+    Тест проверяет:
+        1. insert диапазона выбросит исключение
+        2. Уже вставленные копии будут удалены, размер списка не изменится
+        3. Обход списка посетит столько же элементов, сколько возвращает size()
+*/
+TEST_F(ExceptionSafetyTest, failesAtInsertRangeIntoNode) {
+    unrolled_list<SomeObj, 16> unrolled_list;
+    for (int i = 0; i < 10; ++i) {
+        unrolled_list.emplace_back();
+    }
+    std::list<SomeObj> std_list(5);
+
+    ASSERT_ANY_THROW(unrolled_list.insert(std::next(unrolled_list.cbegin(), 4), std_list.begin(), std_list.end()));
+
+    ASSERT_EQ(unrolled_list.size(), 10);
+    ASSERT_EQ(std::distance(unrolled_list.begin(), unrolled_list.end()), 10);
+}
@@ -0,0 +1,184 @@
+#include <external_unrolled_list.h>
+#include <unrolled_list_parallel.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <filesystem>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::filesystem::path ScratchFile(const std::string& name) {
+    return std::filesystem::temp_directory_path() / ("unrolled_list_external_" + name);
+}
+
+}
+
+TEST(ExternalList, matchesVectorWithSmallPool) {
+    external_unrolled_list<int, 8> list(ScratchFile("random"), 3, 2);
+    std::vector<int> expected;
+    std::mt19937 gen(17);
+
+    for (int step = 0; step < 4000; ++step) {
+        const size_t position = expected.empty() ? 0 : gen() % (expected.size() + 1);
+        switch (gen() % 5) {
+            case 0:
+                list.push_back(step);
+                expected.push_back(step);
+                break;
+            case 1:
+                list.push_front(step);
+                expected.insert(expected.begin(), step);
+                break;
+            case 2:
+                list.insert(std::next(list.cbegin(), position), step);
+                expected.insert(expected.begin() + position, step);
+                break;
+            case 3:
+                if (position < expected.size()) {
+                    list.erase(std::next(list.cbegin(), position));
+                    expected.erase(expected.begin() + position);
+                }
+                break;
+            case 4:
+                if (position < expected.size()) {
+                    *std::next(list.begin(), position) = -step;
+                    expected[position] = -step;
+                }
+                break;
+        }
+        ASSERT_LE(list.resident_nodes(), 3);
+    }
+
+    ASSERT_EQ(list.size(), expected.size());
+    ASSERT_EQ(std::vector<int>(list.begin(), list.end()), expected);
+    ASSERT_EQ(list.front(), expected.front());
+    ASSERT_EQ(list.back(), expected.back());
+    ASSERT_EQ(list[expected.size() / 2], expected[expected.size() / 2]);
+}
+
+/*
+    Итератор держит свою ноду в памяти, пока он жив
+*/
+TEST(ExternalList, iteratorsPinTheirNodes) {
+    external_unrolled_list<int, 4> list(ScratchFile("pins"), 2);
+    for (int i = 0; i < 40; ++i) {
+        list.push_back(i);
+    }
+
+    std::vector<decltype(list)::iterator> held;
+    std::vector<int*> references;
+    for (int i = 0; i < 40; i += 8) {
+        held.push_back(std::next(list.begin(), i));
+        references.push_back(&*held.back());
+    }
+    ASSERT_EQ(std::vector<int>(list.begin(), list.end()).size(), 40);
+    for (size_t i = 0; i < references.size(); ++i) {
+        ASSERT_EQ(*references[i], static_cast<int>(i * 8));
+        *references[i] = -1;
+    }
+    held.clear();
+
+    ASSERT_EQ(std::vector<int>(list.begin(), list.end()).size(), 40);
+    ASSERT_EQ(list[8], -1);
+    ASSERT_EQ(list[9], 9);
+    ASSERT_EQ(list[32], -1);
+}
+
+TEST(ExternalList, clearAndReuse) {
+    external_unrolled_list<double, 16> list(ScratchFile("clear"), 2);
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 500; ++i) {
+            list.push_back(i * 0.5);
+        }
+        list.flush();
+        ASSERT_EQ(list.size(), 500);
+        ASSERT_EQ(list[499], 249.5);
+        while (list.size() > 250) {
+            list.pop_back();
+        }
+        ASSERT_EQ(list.back(), 124.5);
+        list.clear();
+        ASSERT_TRUE(list.empty());
+        ASSERT_EQ(list.begin(), list.end());
+    }
+    ASSERT_FALSE(std::filesystem::exists(ScratchFile("clear")));
+}
+
+/*
+    Сегментированные алгоритмы ul_* идут по нодам файла,
+    закрепляя каждую на время обхода
+*/
+TEST(ExternalList, segmentedAlgorithmsRunOverPagedNodes) {
+    using List = external_unrolled_list<int, 16>;
+    static_assert(ul_segmented_iterator<List::const_iterator>);
+    static_assert(!ul_chunkable_iterator<List::iterator>);
+    static_assert(std::bidirectional_iterator<List::const_segment_iterator>);
+
+    List list(ScratchFile("algorithms"), 3, 2);
+    std::vector<int> expected(1000);
+    std::iota(expected.begin(), expected.end(), 0);
+    for (int value : expected) {
+        list.push_back(value);
+    }
+
+    ASSERT_EQ(ul_accumulate(list.cbegin(), list.cend(), 0LL), std::accumulate(expected.begin(), expected.end(), 0LL));
+    ASSERT_EQ(ul_count(list.cbegin(), list.cend(), 500), 1);
+    {
+        const auto found = ul_find(list.cbegin(), list.cend(), 777);
+        ASSERT_NE(found, list.cend());
+        ASSERT_EQ(*found, 777);
+    }
+    ASSERT_EQ(ul_find(std::next(list.cbegin(), 5), std::next(list.cbegin(), 700), 777), std::next(list.cbegin(), 700));
+
+    ul_fill(std::next(list.begin(), 100), std::next(list.begin(), 900), -1);
+    std::fill(expected.begin() + 100, expected.begin() + 900, -1);
+    std::vector<int> copied;
+    ul_copy(list.cbegin(), list.cend(), std::back_inserter(copied));
+    ASSERT_EQ(copied, expected);
+
+    size_t elements = 0;
+    size_t nodes = 0;
+    // subrange хранит свой begin, и тот держит первую ноду
+    for (const std::span<const int> segment : std::as_const(list).segments()) {
+        ASSERT_LE(list.resident_nodes(), 3 + 1);
+        elements += segment.size();
+        ++nodes;
+    }
+    ASSERT_EQ(elements, expected.size());
+    ASSERT_GE(nodes, expected.size() / 16);
+
+    for (const std::span<int> segment : list.segments()) {
+        for (int& value : segment) {
+            value += 1;
+        }
+    }
+    ASSERT_EQ(list[0], 1);
+    ASSERT_EQ(list[500], 0);
+    ASSERT_EQ(list[999], 1000);
+}
+
+/*
+    Последовательный обход с упреждающим чтением в фоне
+    видит то же, что записано, и не раздувает пул
+*/
+TEST(ExternalList, readAheadScansRepeatedly) {
+    external_unrolled_list<std::int64_t, 32> list(ScratchFile("readahead"), 8, 4);
+    for (std::int64_t i = 0; i < 20000; ++i) {
+        list.push_back(i);
+    }
+    for (int round = 0; round < 5; ++round) {
+        std::int64_t expected = 0;
+        for (const std::int64_t value : std::as_const(list)) {
+            ASSERT_EQ(value, expected++);
+        }
+        ASSERT_EQ(expected, 20000);
+        ASSERT_LE(list.resident_nodes(), 8);
+        list.erase(std::next(list.cbegin(), 10000));
+        list.insert(std::next(list.cbegin(), 10000), 10000);
+    }
+}
@@ -0,0 +1,162 @@
+#include <unrolled_list.h>
+#include <unrolled_list_view.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <ios>
+#include <ranges>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Record {
+    std::int64_t Key;
+    char Tag;
+
+    bool operator==(const Record&) const = default;
+};
+
+struct alignas(16) Wide {
+    double Values[3];
+
+    bool operator==(const Wide&) const = default;
+};
+
+std::filesystem::path TempFile(const std::string& name) {
+    return std::filesystem::temp_directory_path() / ("unrolled_list_" + name + ".bin");
+}
+
+template<typename Range>
+std::vector<size_t> SegmentSizes(const Range& segments) {
+    std::vector<size_t> sizes;
+    for (auto segment : segments) {
+        sizes.push_back(segment.size());
+    }
+    return sizes;
+}
+
+}
+
+TEST(FileTest, saveAndLoadKeepElements) {
+    const auto path = TempFile("round_trip");
+    for (int count : {0, 1, 7, 100, 5000}) {
+        unrolled_list<int, 7> saved;
+        for (int i = 0; i < count; ++i) {
+            saved.push_back(i * 3);
+        }
+        saved.save(path);
+
+        unrolled_list<int, 7> same{1, 2, 3};
+        same.load(path);
+        ASSERT_EQ(same, saved);
+        ASSERT_EQ(SegmentSizes(same.segments()), SegmentSizes(saved.segments()));
+
+        unrolled_list<int, 3> smaller;
+        smaller.load(path);
+        ASSERT_THAT(smaller, ::testing::ElementsAreArray(saved));
+
+        unrolled_list<int, 64, std::allocator<int>, ul_order_statistics_index> indexed;
+        indexed.load(path);
+        ASSERT_THAT(indexed, ::testing::ElementsAreArray(saved));
+        if (count > 0) {
+            ASSERT_EQ(indexed[count - 1], (count - 1) * 3);
+        }
+    }
+    std::filesystem::remove(path);
+}
+
+/*
+    Файл другого типа или обрезанный файл не загружается, список не меняется
+*/
+TEST(FileTest, loadRejectsForeignFiles) {
+    const auto path = TempFile("foreign");
+    unrolled_list<Record, 5> saved;
+    for (int i = 0; i < 50; ++i) {
+        saved.push_back({i, static_cast<char>('a' + i % 26)});
+    }
+    saved.save(path);
+
+    unrolled_list<int, 5> ints{1, 2, 3};
+    ASSERT_THROW(ints.load(path), std::ios_base::failure);
+    ASSERT_THAT(ints, ::testing::ElementsAre(1, 2, 3));
+
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 40);
+    unrolled_list<Record, 5> records{{7, 'x'}};
+    ASSERT_THROW(records.load(path), std::ios_base::failure);
+    ASSERT_EQ(records.size(), 1);
+    ASSERT_THROW(unrolled_list_view<Record>{path}, std::ios_base::failure);
+
+    ASSERT_THROW(records.load(TempFile("missing")), std::ios_base::failure);
+    ASSERT_THROW(unrolled_list_view<Record>{TempFile("missing")}, std::system_error);
+    std::filesystem::remove(path);
+}
+
+/*
+    Файл обрезан внутри выравнивания последней записи: данные записи целы,
+    но её полная длина выходит за конец файла. Представление должно
+    отвергнуть такой файл, а не читать за его границей.
+*/
+TEST(FileTest, viewRejectsTruncatedPadding) {
+    const auto path = TempFile("padding");
+    unrolled_list<std::int32_t, 3> saved;
+    for (int i = 0; i < 9; ++i) {
+        saved.push_back(i);
+    }
+    ASSERT_EQ(SegmentSizes(saved.segments()), std::vector<size_t>({3, 3, 3}));
+    saved.save(path);
+    {
+        const unrolled_list_view<std::int32_t> view(path);
+        ASSERT_THAT(view, ::testing::ElementsAreArray(saved));
+    }
+
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 2);
+    ASSERT_THROW(unrolled_list_view<std::int32_t>{path}, std::ios_base::failure);
+    std::filesystem::remove(path);
+}
+
+TEST(FileTest, viewMapsSavedNodes) {
+    const auto path = TempFile("view");
+    unrolled_list<Record, 6> saved;
+    for (int i = 0; i < 1000; ++i) {
+        saved.push_back({i, static_cast<char>(i)});
+    }
+    saved.erase(saved.begin() + 100, saved.begin() + 117);
+    saved.save(path);
+
+    const unrolled_list_view<Record> view(path);
+    ASSERT_EQ(view.size(), saved.size());
+    ASSERT_THAT(view, ::testing::ElementsAreArray(saved));
+    ASSERT_EQ(SegmentSizes(view.segments()), SegmentSizes(saved.segments()));
+    ASSERT_EQ(view.front(), saved.front());
+
+    unrolled_list<Record, 6> copy(view.begin(), view.end());
+    ASSERT_EQ(copy, saved);
+    std::filesystem::remove(path);
+}
+
+TEST(FileTest, overalignedAndEmpty) {
+    const auto path = TempFile("wide");
+    unrolled_list<Wide, 3> saved;
+    for (int i = 0; i < 10; ++i) {
+        saved.push_back({{i * 1.0, i * 2.0, i * 3.0}});
+    }
+    saved.save(path);
+    {
+        const unrolled_list_view<Wide> view(path);
+        ASSERT_THAT(view, ::testing::ElementsAreArray(saved));
+        for (auto segment : view.segments()) {
+            ASSERT_EQ(reinterpret_cast<std::uintptr_t>(segment.data()) % alignof(Wide), 0);
+        }
+    }
+
+    unrolled_list<Wide, 3>().save(path);
+    const unrolled_list_view<Wide> empty(path);
+    ASSERT_TRUE(empty.empty());
+    ASSERT_EQ(empty.begin(), empty.end());
+    ASSERT_EQ(std::ranges::distance(empty.segments()), 0);
+    std::filesystem::remove(path);
+}
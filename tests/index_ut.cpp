@@ -0,0 +1,88 @@
+#include <unrolled_list.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <random>
+#include <vector>
+
+using indexed_list = unrolled_list<int, 4, std::allocator<int>, ul_order_statistics_index>;
+
+template<typename List>
+void ExpectSameElements(List& list, const std::vector<int>& reference) {
+    ASSERT_EQ(list.size(), reference.size());
+    for (size_t i = 0; i < reference.size(); ++i) {
+        ASSERT_EQ(list[i], reference[i]);
+        ASSERT_EQ(list.index_of(list.nth(i)), i);
+    }
+    ASSERT_EQ(list.nth(reference.size()), list.end());
+}
+
+/*
+    Случайная последовательность push_*, pop_*, insert и erase (одиночных и диапазонных).
+    После каждой операции индекс должен совпадать с std::vector
+*/
+TEST(OrderStatisticsIndex, randomOperationsMatchVector) {
+    indexed_list list;
+    std::vector<int> reference;
+    std::mt19937 gen(42);
+
+    for (int step = 0; step < 2000; ++step) {
+        const int op = gen() % 7;
+        const size_t position = reference.empty() ? 0 : gen() % reference.size();
+        if (op == 0) {
+            list.push_back(step);
+            reference.push_back(step);
+        } else if (op == 1) {
+            list.push_front(step);
+            reference.insert(reference.begin(), step);
+        } else if (op == 2) {
+            list.insert(list.nth(position), step);
+            reference.insert(reference.begin() + position, step);
+        } else if (op == 3 && !reference.empty()) {
+            list.erase(list.nth(position));
+            reference.erase(reference.begin() + position);
+        } else if (op == 4) {
+            std::vector<int> batch(gen() % 11, step);
+            list.insert(list.nth(position), batch.begin(), batch.end());
+            reference.insert(reference.begin() + position, batch.begin(), batch.end());
+        } else if (op == 5 && !reference.empty()) {
+            const size_t last = position + gen() % (reference.size() - position + 1);
+            list.erase(list.nth(position), list.nth(last));
+            reference.erase(reference.begin() + position, reference.begin() + last);
+        } else if (op == 6 && !reference.empty()) {
+            list.pop_front();
+            reference.erase(reference.begin());
+        }
+        if (step % 50 == 0) {
+            ExpectSameElements(list, reference);
+        }
+    }
+    ExpectSameElements(list, reference);
+}
+
+TEST(OrderStatisticsIndex, iteratorJumps) {
+    indexed_list list;
+    for (int i = 0; i < 100; ++i) {
+        list.push_back(i);
+    }
+
+    auto it = list.begin() + 57;
+    ASSERT_EQ(*it, 57);
+    ASSERT_EQ(*(it - 50), 7);
+    ASSERT_EQ(*(it + 42), 99);
+    ASSERT_EQ(it + 43, list.end());
+    ASSERT_EQ(list.at(13), 13);
+    ASSERT_THROW(list.at(100), std::out_of_range);
+}
+
+TEST(OrderStatisticsIndex, linearFallbackWithoutIndex) {
+    unrolled_list<int, 3> list;
+    std::vector<int> reference;
+    for (int i = 0; i < 50; ++i) {
+        list.push_front(i);
+        reference.insert(reference.begin(), i);
+    }
+
+    ExpectSameElements(list, reference);
+}
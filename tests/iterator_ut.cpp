@@ -2,6 +2,9 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <iterator>
+#include <vector>
+
 TEST(UnrolledListIterator, IncrementIterator) {
     unrolled_list<int, 3> ul{1, 2, 3, 4, 5};
     auto it = ul.begin();
@@ -84,3 +87,51 @@ TEST(UnrolledListIterator, IteratorComparison) {
     auto empty_ul = unrolled_list<int, 3>{};
     EXPECT_EQ(empty_ul.begin(), empty_ul.end());
 }
+
+TEST(UnrolledListIterator, DecrementFromEnd) {
+    unrolled_list<int, 3> ul{10, 20, 30, 40, 50};
+
+    EXPECT_EQ(*std::prev(ul.end()), 50);
+    EXPECT_EQ(*(ul.end() - 2), 40);
+    EXPECT_EQ(*ul.rbegin(), 50);
+    EXPECT_EQ(std::vector<int>(ul.rbegin(), ul.rend()), (std::vector<int>{50, 40, 30, 20, 10}));
+
+    // partially filled nodes in the middle
+    ul.erase(ul.begin() + 1);
+    ul.push_front(5);
+    EXPECT_EQ(std::vector<int>(ul.crbegin(), ul.crend()), (std::vector<int>{50, 40, 30, 10, 5}));
+
+    ul.pop_back();
+    EXPECT_EQ(*std::prev(ul.end()), 40);
+}
+
+TEST(UnrolledListIterator, EndSurvivesMoveAndSwap) {
+    unrolled_list<int, 2> first{1, 2, 3};
+    unrolled_list<int, 2> second{4};
+
+    first.swap(second);
+    EXPECT_EQ(*std::prev(first.end()), 4);
+    EXPECT_EQ(std::vector<int>(second.rbegin(), second.rend()), (std::vector<int>{3, 2, 1}));
+
+    unrolled_list<int, 2> moved(std::move(second));
+    EXPECT_EQ(*std::prev(moved.end()), 3);
+    EXPECT_EQ(second.begin(), second.end());
+    EXPECT_EQ(std::distance(moved.begin(), moved.end()), 3);
+
+    unrolled_list<int, 2> empty;
+    empty.swap(moved);
+    EXPECT_EQ(moved.begin(), moved.end());
+    EXPECT_EQ(*std::prev(empty.end()), 3);
+}
+
+TEST(UnrolledListIterator, IndexedDecrementFromEnd) {
+    unrolled_list<int, 4, std::allocator<int>, ul_order_statistics_index> ul;
+    for (int i = 0; i < 100; ++i) {
+        ul.push_back(i);
+    }
+
+    EXPECT_EQ(*(ul.end() - 1), 99);
+    EXPECT_EQ(*(ul.end() - 37), 63);
+    EXPECT_EQ(ul.begin() + 100, ul.end());
+    EXPECT_EQ(*(ul.begin() + 99), 99);
+}
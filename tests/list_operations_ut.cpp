@@ -0,0 +1,294 @@
+#include <unrolled_list.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <list>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+
+class Tracked {
+public:
+    static inline int MovesCount = 0;
+
+    Tracked(int key, int id) : Key(key), Id(id) {}
+
+    Tracked(const Tracked&) = default;
+
+    Tracked(Tracked&& other) noexcept : Key(other.Key), Id(other.Id) {
+        ++MovesCount;
+    }
+
+    Tracked& operator=(const Tracked&) = default;
+
+    Tracked& operator=(Tracked&& other) noexcept {
+        ++MovesCount;
+        Key = other.Key;
+        Id = other.Id;
+        return *this;
+    }
+
+    bool operator==(const Tracked&) const = default;
+
+    int Key;
+    int Id;
+};
+
+bool ByKey(const Tracked& lhs, const Tracked& rhs) {
+    return lhs.Key < rhs.Key;
+}
+
+// No nothrow move, so sort and merge copy it; the copy throws once the budget is spent.
+class CopyLimited {
+public:
+    static inline int CopiesLeft = 0;
+
+    CopyLimited(int key) : Key(key) {}
+
+    CopyLimited(const CopyLimited& other) : Key(other.Key) {
+        if (CopiesLeft-- == 0) {
+            throw std::runtime_error("copy");
+        }
+    }
+
+    CopyLimited& operator=(const CopyLimited&) = default;
+
+    bool operator<(const CopyLimited& other) const {
+        return Key < other.Key;
+    }
+
+    int Key;
+};
+
+template<typename List>
+std::vector<int> Keys(const List& list) {
+    std::vector<int> keys;
+    for (const auto& value : list) {
+        keys.push_back(value.Key);
+    }
+    return keys;
+}
+
+template<typename List>
+void ExpectNoEmptyNodes(const List& list) {
+    size_t total = 0;
+    for (auto segment : list.segments()) {
+        ASSERT_FALSE(segment.empty());
+        total += segment.size();
+    }
+    ASSERT_EQ(total, list.size());
+    ASSERT_EQ(static_cast<size_t>(std::distance(list.begin(), list.end())), list.size());
+}
+
+}
+
+TEST(ListOperations, sortIsStable) {
+    std::mt19937 gen(7);
+    for (size_t count : {0, 1, 5, 37, 1000}) {
+        unrolled_list<Tracked, 6> ul;
+        std::vector<Tracked> expected;
+        for (size_t i = 0; i < count; ++i) {
+            Tracked value(static_cast<int>(gen() % 20), static_cast<int>(i));
+            ul.push_back(value);
+            expected.push_back(value);
+        }
+
+        ul.sort(ByKey);
+        std::stable_sort(expected.begin(), expected.end(), ByKey);
+        ASSERT_EQ(std::vector<Tracked>(ul.begin(), ul.end()), expected);
+        ASSERT_EQ(ul.size(), count);
+    }
+}
+
+TEST(ListOperations, sortWithIndex) {
+    unrolled_list<int, 4, std::allocator<int>, ul_order_statistics_index> ul;
+    for (int i = 0; i < 200; ++i) {
+        ul.push_front(i % 17);
+    }
+
+    ul.sort(std::greater<>());
+    ASSERT_TRUE(std::is_sorted(ul.begin(), ul.end(), std::greater<>()));
+    for (size_t i = 0; i < ul.size(); ++i) {
+        ASSERT_EQ(ul[i], *(ul.begin() + i));
+    }
+}
+
+/*
+    Уже упорядоченные ноды сливаются перевешиванием целиком,
+    элементы не перемещаются
+*/
+TEST(ListOperations, sortedNodesAreNotMoved) {
+    unrolled_list<Tracked, 4> first;
+    unrolled_list<Tracked, 4> second;
+    for (int i = 0; i < 16; ++i) {
+        first.emplace_back(i, 0);
+        second.emplace_back(100 + i, 1);
+    }
+    Tracked::MovesCount = 0;
+
+    second.merge(first, ByKey);
+    ASSERT_TRUE(first.empty());
+    ASSERT_EQ(second.size(), 32);
+    ASSERT_EQ(second.front().Key, 0);
+    ASSERT_EQ(second.back().Key, 115);
+
+    second.sort(ByKey);
+    ASSERT_EQ(Tracked::MovesCount, 0);
+}
+
+TEST(ListOperations, operationsMatchStdList) {
+    std::mt19937 gen(42);
+    for (int round = 0; round < 50; ++round) {
+        unrolled_list<int, 5> first;
+        unrolled_list<int, 5> second;
+        std::list<int> first_expected;
+        std::list<int> second_expected;
+        for (int i = static_cast<int>(gen() % 60); i > 0; --i) {
+            const int value = static_cast<int>(gen() % 10);
+            first.push_back(value);
+            first_expected.push_back(value);
+        }
+        for (int i = static_cast<int>(gen() % 60); i > 0; --i) {
+            const int value = static_cast<int>(gen() % 10);
+            second.push_front(value);
+            second_expected.push_front(value);
+        }
+
+        first.sort();
+        first_expected.sort();
+        second.sort();
+        second_expected.sort();
+        first.merge(std::move(second));
+        first_expected.merge(second_expected);
+        ASSERT_TRUE(second.empty());
+        ASSERT_THAT(first, ::testing::ElementsAreArray(first_expected));
+
+        ASSERT_EQ(first.unique(), first_expected.unique());
+        ASSERT_THAT(first, ::testing::ElementsAreArray(first_expected));
+
+        const int odd = first.empty() ? 0 : first.back();
+        ASSERT_EQ(first.remove(odd), first_expected.remove(odd));
+        auto is_even = [](int value) { return value % 2 == 0; };
+        ASSERT_EQ(first.remove_if(is_even), first_expected.remove_if(is_even));
+        ASSERT_THAT(first, ::testing::ElementsAreArray(first_expected));
+        ASSERT_EQ(first.size(), first_expected.size());
+    }
+}
+
+TEST(ListOperations, removeCompactsNodes) {
+    unrolled_list<int, 4> ul;
+    for (int i = 0; i < 40; ++i) {
+        ul.push_back(i);
+    }
+
+    ASSERT_EQ(ul.remove_if([](int value) { return value % 4 != 0; }), 30);
+    ASSERT_THAT(ul, ::testing::ElementsAre(0, 4, 8, 12, 16, 20, 24, 28, 32, 36));
+    ASSERT_EQ(std::ranges::distance(ul.segments()), 3);
+
+    ASSERT_EQ(ul.remove(ul.front()), 1);
+    ASSERT_EQ(ul.front(), 4);
+    ASSERT_EQ(ul.remove(100), 0);
+}
+
+TEST(ListOperations, uniqueWithPredicate) {
+    unrolled_list<int, 3> ul{1, 2, 4, 5, 7, 8, 9, 11};
+
+    ASSERT_EQ(ul.unique([](int lhs, int rhs) { return rhs - lhs == 1; }), 3);
+    ASSERT_THAT(ul, ::testing::ElementsAre(1, 4, 7, 9, 11));
+}
+
+/*
+    Если компаратор бросает исключение, ни один элемент не теряется
+*/
+TEST(ListOperations, throwingCompareKeepsElements) {
+    for (int limit = 0; limit < 300; limit += 7) {
+        unrolled_list<int, 4> first;
+        unrolled_list<int, 4> second;
+        std::vector<int> all;
+        for (int i = 0; i < 50; ++i) {
+            first.push_back((i * 37) % 50);
+            second.push_back(i);
+            all.push_back((i * 37) % 50);
+            all.push_back(i);
+        }
+        int calls = 0;
+        auto compare = [&calls, limit](int lhs, int rhs) {
+            if (++calls > limit) {
+                throw std::runtime_error("compare");
+            }
+            return lhs < rhs;
+        };
+
+        try {
+            first.sort(compare);
+            first.merge(second, compare);
+        } catch (const std::runtime_error&) {
+        }
+
+        std::vector<int> kept(first.begin(), first.end());
+        kept.insert(kept.end(), second.begin(), second.end());
+        ASSERT_EQ(kept.size(), first.size() + second.size());
+        ASSERT_THAT(kept, ::testing::UnorderedElementsAreArray(all));
+    }
+}
+
+/*
+    Если копирование элемента бросает исключение во время sort,
+    ни один элемент не теряется и в списке не остаётся пустых нод
+*/
+TEST(ListOperations, throwingCopyInSortKeepsNodes) {
+    for (int budget = 0; budget < 120; budget += 3) {
+        unrolled_list<CopyLimited, 4> ul;
+        std::vector<int> all;
+        for (int i = 0; i < 40; ++i) {
+            ul.emplace_back((i * 17) % 40);
+            all.push_back((i * 17) % 40);
+        }
+
+        CopyLimited::CopiesLeft = budget;
+        try {
+            ul.sort();
+        } catch (const std::runtime_error&) {
+        }
+        CopyLimited::CopiesLeft = -1;
+
+        ExpectNoEmptyNodes(ul);
+        ASSERT_THAT(Keys(ul), ::testing::UnorderedElementsAreArray(all));
+    }
+}
+
+/*
+    То же для merge: элементы остаются в одном из двух списков, пустых нод нет
+*/
+TEST(ListOperations, throwingCopyInMergeKeepsNodes) {
+    for (int budget = 0; budget < 60; budget += 2) {
+        unrolled_list<CopyLimited, 4> first;
+        unrolled_list<CopyLimited, 4> second;
+        std::vector<int> all;
+        for (int i = 0; i < 20; ++i) {
+            first.emplace_back(2 * i);
+            second.emplace_back(2 * i + 1);
+            all.push_back(2 * i);
+            all.push_back(2 * i + 1);
+        }
+
+        CopyLimited::CopiesLeft = budget;
+        try {
+            first.merge(second);
+        } catch (const std::runtime_error&) {
+        }
+        CopyLimited::CopiesLeft = -1;
+
+        ExpectNoEmptyNodes(first);
+        ExpectNoEmptyNodes(second);
+        std::vector<int> kept = Keys(first);
+        std::vector<int> rest = Keys(second);
+        kept.insert(kept.end(), rest.begin(), rest.end());
+        ASSERT_THAT(kept, ::testing::UnorderedElementsAreArray(all));
+    }
+}
@@ -0,0 +1,130 @@
+#include <unrolled_list.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <list>
+#include <string>
+
+class CopyCounter {
+public:
+    static inline int CopiesCount = 0;
+    static inline int MovesCount = 0;
+
+    explicit CopyCounter(int value) : Value(value) {}
+
+    CopyCounter(const CopyCounter& other) : Value(other.Value) {
+        ++CopiesCount;
+    }
+
+    CopyCounter(CopyCounter&& other) noexcept : Value(other.Value) {
+        ++MovesCount;
+    }
+
+    CopyCounter& operator=(const CopyCounter& other) {
+        ++CopiesCount;
+        Value = other.Value;
+        return *this;
+    }
+
+    CopyCounter& operator=(CopyCounter&& other) noexcept {
+        ++MovesCount;
+        Value = other.Value;
+        return *this;
+    }
+
+    int Value;
+};
+
+class MoveSemanticsTest : public testing::Test {
+public:
+    void SetUp() override {
+        CopyCounter::CopiesCount = 0;
+        CopyCounter::MovesCount = 0;
+    }
+};
+
+/*
+    Тест проверяет, что emplace*, push_* от rvalue и сдвиги элементов внутри нод
+    при insert/erase не делают ни одной копии
+*/
+TEST_F(MoveSemanticsTest, noCopiesOnModifiers) {
+    unrolled_list<CopyCounter, 4> list;
+    for (int i = 0; i < 20; ++i) {
+        list.emplace_back(i);
+        list.push_front(CopyCounter(-i));
+    }
+    list.emplace(list.begin() + 7, 100);
+    list.insert(list.begin() + 3, CopyCounter(200));
+    list.erase(list.begin() + 5);
+    list.pop_front();
+
+    ASSERT_EQ(list.size(), 40);
+    ASSERT_EQ(CopyCounter::CopiesCount, 0);
+}
+
+TEST_F(MoveSemanticsTest, moveConstructAndAssign) {
+    unrolled_list<CopyCounter, 4> list;
+    for (int i = 0; i < 10; ++i) {
+        list.emplace_back(i);
+    }
+    auto first = list.begin();
+
+    unrolled_list<CopyCounter, 4> moved(std::move(list));
+    ASSERT_TRUE(list.empty());
+    ASSERT_EQ(moved.size(), 10);
+    ASSERT_EQ(moved.begin(), first);
+
+    unrolled_list<CopyCounter, 4> assigned;
+    assigned.emplace_back(-1);
+    assigned = std::move(moved);
+    ASSERT_TRUE(moved.empty());
+    ASSERT_EQ(assigned.size(), 10);
+    ASSERT_EQ(assigned.begin(), first);
+    ASSERT_EQ(assigned.back().Value, 9);
+
+    ASSERT_EQ(CopyCounter::CopiesCount, 0);
+}
+
+TEST_F(MoveSemanticsTest, emplaceMatchesStdList) {
+    std::list<std::string> std_list;
+    unrolled_list<std::string, 3> unrolled_list;
+
+    for (int i = 0; i < 300; ++i) {
+        auto std_it = std_list.begin();
+        auto unrolled_it = unrolled_list.begin();
+        std::advance(std_it, (i * 7) % (std_list.size() + 1));
+        std::advance(unrolled_it, (i * 7) % (std_list.size() + 1));
+
+        std_list.emplace(std_it, 3, static_cast<char>('a' + i % 26));
+        auto result = unrolled_list.emplace(unrolled_it, 3, static_cast<char>('a' + i % 26));
+        ASSERT_EQ(*result, std::string(3, static_cast<char>('a' + i % 26)));
+    }
+    unrolled_list.emplace_front("front");
+    std_list.emplace_front("front");
+
+    ASSERT_EQ(unrolled_list.size(), std_list.size());
+    ASSERT_THAT(unrolled_list, ::testing::ElementsAreArray(std_list));
+}
+
+/*
+    Ноды хранят смещение начала, поэтому emplace_front/pop_front
+    создают и разрушают элементы на месте, не сдвигая остальные
+*/
+TEST_F(MoveSemanticsTest, frontOperationsDoNotShift) {
+    unrolled_list<CopyCounter, 8> list;
+    for (int i = 0; i < 100; ++i) {
+        list.emplace_front(i);
+    }
+    for (int i = 0; i < 50; ++i) {
+        list.pop_front();
+    }
+    for (int i = 0; i < 100; ++i) {
+        list.emplace_back(i);
+        list.pop_front();
+    }
+
+    ASSERT_EQ(list.size(), 50);
+    ASSERT_EQ(list.front().Value, 50);
+    ASSERT_EQ(CopyCounter::MovesCount, 0);
+}
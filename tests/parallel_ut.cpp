@@ -0,0 +1,104 @@
+#include <unrolled_list_parallel.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+class ParallelTest : public testing::Test {
+public:
+    ul_thread_pool Pool{3};
+    ul_parallel_policy Policy = ul_par.on(Pool);
+};
+
+TEST_F(ParallelTest, chunksFollowElementCount) {
+    unrolled_list<int, 8> list;
+    for (int i = 0; i < 1000; ++i) {
+        list.push_back(i);
+    }
+
+    const auto chunks = ul_split_chunks(list.begin(), list.end(), 7);
+    ASSERT_EQ(chunks.count(), 7);
+    ASSERT_EQ(chunks.total, 1000);
+    for (size_t i = 0; i <= chunks.count(); ++i) {
+        ASSERT_EQ(list.index_of(chunks.bounds[i]), chunks.offsets[i]);
+    }
+    for (size_t i = 0; i < chunks.count(); ++i) {
+        ASSERT_NEAR(chunks.offsets[i + 1] - chunks.offsets[i], 1000 / 7, 1);
+    }
+
+    ASSERT_EQ(ul_split_chunks(list.begin(), list.begin() + 3, 10).count(), 3);
+    ASSERT_EQ(ul_split_chunks(list.end(), list.end(), 10).count(), 0);
+}
+
+TEST_F(ParallelTest, algorithmsMatchStd) {
+    unrolled_list<int, 16> list;
+    std::vector<int> reference;
+    std::mt19937 gen(5);
+    for (int i = 0; i < 20000; ++i) {
+        const int value = static_cast<int>(gen() % 1000);
+        list.push_back(value);
+        reference.push_back(value);
+    }
+
+    auto is_even = [](int value) { return value % 2 == 0; };
+    ASSERT_EQ(ul_count_if(Policy, list.begin(), list.end(), is_even),
+        std::count_if(reference.begin(), reference.end(), is_even));
+    ASSERT_EQ(ul_reduce(Policy, list.begin(), list.end(), 0L),
+        std::accumulate(reference.begin(), reference.end(), 0L));
+
+    auto is_answer = [](int value) { return value == 999; };
+    const auto found = ul_find_if(Policy, list.begin(), list.end(), is_answer);
+    ASSERT_EQ(list.index_of(found), std::find_if(reference.begin(), reference.end(), is_answer) - reference.begin());
+    ASSERT_EQ(ul_find_if(Policy, list.begin(), list.end(), [](int value) { return value < 0; }), list.end());
+
+    std::atomic<long> sum = 0;
+    ul_for_each(Policy, list.begin(), list.end(), [&sum](int value) { sum += value; });
+    ASSERT_EQ(sum, std::accumulate(reference.begin(), reference.end(), 0L));
+
+    std::vector<int> doubled(reference.size());
+    ASSERT_EQ(ul_transform(Policy, list.begin(), list.end(), doubled.begin(), [](int value) { return value * 2; }),
+        doubled.end());
+    ul_transform(Policy, list.begin(), list.end(), list.begin(), [](int value) { return value + 1; });
+    for (size_t i = 0; i < reference.size(); ++i) {
+        ASSERT_EQ(doubled[i], reference[i] * 2);
+        ASSERT_EQ(list[i], reference[i] + 1);
+    }
+
+    ul_sort(Policy, list.begin(), list.end());
+    std::sort(reference.begin(), reference.end());
+    for (int& value : reference) {
+        ++value;
+    }
+    ASSERT_THAT(list, ::testing::ElementsAreArray(reference));
+}
+
+TEST_F(ParallelTest, sortsStringsWithComparator) {
+    unrolled_list<std::string, 5> list;
+    for (int i = 0; i < 500; ++i) {
+        list.push_front(std::to_string(i * 7919 % 500));
+    }
+    ul_sort(Policy, list.begin(), list.end(), std::greater<>());
+    ASSERT_TRUE(std::is_sorted(list.begin(), list.end(), std::greater<>()));
+    ASSERT_EQ(list.size(), 500);
+}
+
+TEST_F(ParallelTest, rethrowsTaskException) {
+    unrolled_list<int, 4> list{1, 2, 3, 4, 5, 6, 7, 8};
+    ASSERT_THROW(ul_for_each(Policy, list.begin(), list.end(), [](int value) {
+        if (value == 6) {
+            throw std::runtime_error("six");
+        }
+    }), std::runtime_error);
+
+    // nested parallel calls run on the same pool
+    std::atomic<int> total = 0;
+    ul_for_each(Policy, list.begin(), list.end(), [&](int) {
+        total += ul_reduce(Policy, list.begin(), list.end(), 0);
+    });
+    ASSERT_EQ(total, 8 * 36);
+}
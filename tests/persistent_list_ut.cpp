@@ -0,0 +1,294 @@
+#include <persistent_unrolled_list.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <atomic>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+class CountedCopy {
+public:
+    static inline int CopiesCount = 0;
+    static inline int CopiesLeft = 1 << 30;
+
+    explicit CountedCopy(int value) : Value(value) {}
+
+    CountedCopy(const CountedCopy& other) : Value(other.Value) {
+        if (CopiesLeft-- == 0) {
+            throw std::runtime_error("copy");
+        }
+        ++CopiesCount;
+    }
+
+    CountedCopy(CountedCopy&&) noexcept = default;
+    CountedCopy& operator=(const CountedCopy&) = default;
+    CountedCopy& operator=(CountedCopy&&) noexcept = default;
+
+    bool operator==(const CountedCopy&) const = default;
+
+    int Value;
+};
+
+std::atomic<size_t> BytesAllocated = 0;
+
+template<typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    CountingAllocator() = default;
+
+    template<typename U>
+    CountingAllocator(const CountingAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        BytesAllocated += n * sizeof(T);
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) {
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    bool operator==(const CountingAllocator&) const = default;
+};
+
+}
+
+TEST(PersistentList, matchesVectorWithFrozenSnapshots) {
+    using List = persistent_unrolled_list<std::string, 4>;
+    std::mt19937 gen(11);
+    List list;
+    std::vector<std::string> expected;
+    std::vector<std::pair<List::snapshot_type, std::vector<std::string>>> snapshots;
+
+    for (int step = 0; step < 3000; ++step) {
+        const size_t position = expected.empty() ? 0 : gen() % (expected.size() + 1);
+        const std::string value = std::to_string(step);
+        switch (gen() % 6) {
+            case 0:
+                list.push_back(value);
+                expected.push_back(value);
+                break;
+            case 1:
+                list.push_front(value);
+                expected.insert(expected.begin(), value);
+                break;
+            case 2:
+            case 3:
+                list.insert(std::next(list.begin(), position), value);
+                expected.insert(expected.begin() + position, value);
+                break;
+            case 4:
+                if (position < expected.size()) {
+                    list.erase(std::next(list.begin(), position));
+                    expected.erase(expected.begin() + position);
+                }
+                break;
+            case 5:
+                if (position < expected.size()) {
+                    list.edit(std::next(list.begin(), position)) = value;
+                    expected[position] = value;
+                }
+                break;
+        }
+        if (step % 100 == 0) {
+            snapshots.emplace_back(list.snapshot(), expected);
+        }
+    }
+
+    ASSERT_THAT(list, ::testing::ElementsAreArray(expected));
+    ASSERT_EQ(list.size(), expected.size());
+    for (const auto& [snapshot, frozen] : snapshots) {
+        ASSERT_THAT(snapshot, ::testing::ElementsAreArray(frozen));
+        ASSERT_EQ(snapshot.size(), frozen.size());
+    }
+}
+
+/*
+    Снимок делит ноды со списком, запись копирует только изменяемую ноду
+*/
+TEST(PersistentList, writeClonesOnlyTouchedNode) {
+    persistent_unrolled_list<CountedCopy, 8> list;
+    for (int i = 0; i < 80; ++i) {
+        list.emplace_back(i);
+    }
+    CountedCopy::CopiesCount = 0;
+
+    auto snapshot = list.snapshot();
+    auto copy = list;
+    ASSERT_EQ(CountedCopy::CopiesCount, 0);
+    ASSERT_EQ(&snapshot[37], &list[37]);
+
+    list.edit(std::next(list.begin(), 37)).Value = -1;
+    ASSERT_EQ(CountedCopy::CopiesCount, 8);
+    ASSERT_EQ(list[37].Value, -1);
+    ASSERT_EQ(snapshot[37].Value, 37);
+    ASSERT_EQ(copy[37].Value, 37);
+    ASSERT_NE(&snapshot[37], &list[37]);
+    ASSERT_EQ(&snapshot[36 - 8], &list[36 - 8]);
+    ASSERT_EQ(&snapshot[40], &list[40]);
+
+    list.edit(std::next(list.begin(), 38)).Value = -2;
+    list.pop_front();
+    list.emplace_back(80);
+    ASSERT_EQ(CountedCopy::CopiesCount, 16);
+    ASSERT_EQ(snapshot.front().Value, 0);
+    ASSERT_EQ(snapshot.back().Value, 79);
+    ASSERT_EQ(snapshot.size(), 80);
+    ASSERT_EQ(list.size(), 80);
+}
+
+/*
+    Первая запись после снимка копирует только путь к изменяемой ноде:
+    её стоимость почти не растёт с размером списка
+*/
+TEST(PersistentList, writeAfterSnapshotCopiesOnlyPath) {
+    using List = persistent_unrolled_list<int, 64, CountingAllocator<int>>;
+    const auto bytes_of_write_after_snapshot = [](const int size) {
+        List list;
+        for (int i = 0; i < size; ++i) {
+            list.push_back(i);
+        }
+        const auto snapshot = list.snapshot();
+        BytesAllocated = 0;
+        list.edit(std::next(list.begin(), size / 2)) = -1;
+        list.insert(std::next(list.begin(), size / 3), -2);
+        EXPECT_EQ(snapshot[size / 2], size / 2);
+        return BytesAllocated.load();
+    };
+
+    const size_t small = bytes_of_write_after_snapshot(1 << 12);
+    const size_t large = bytes_of_write_after_snapshot(1 << 20);
+    // 2^20 элементов -- это 2^15 нод: копия плоского списка нод заняла бы 256 KiB
+    ASSERT_LT(large, 16 * 1024);
+    ASSERT_LE(large, 2 * small);
+}
+
+/*
+    Удаления сливают и перераспределяют узлы позвоночника,
+    снимки при этом не меняются
+*/
+TEST(PersistentList, shrinkingKeepsSnapshots) {
+    using List = persistent_unrolled_list<int, 2>;
+    std::mt19937 gen(3);
+    List list;
+    std::vector<int> expected;
+    for (int i = 0; i < 5000; ++i) {
+        const size_t position = gen() % (expected.size() + 1);
+        list.insert(std::next(list.begin(), position), i);
+        expected.insert(expected.begin() + position, i);
+    }
+
+    std::vector<std::pair<List::snapshot_type, std::vector<int>>> snapshots;
+    while (!expected.empty()) {
+        if (expected.size() % 500 == 0) {
+            snapshots.emplace_back(list.snapshot(), expected);
+        }
+        const size_t position = gen() % expected.size();
+        ASSERT_EQ(list[position], expected[position]);
+        list.erase(std::next(list.begin(), position));
+        expected.erase(expected.begin() + position);
+    }
+
+    ASSERT_TRUE(list.empty());
+    ASSERT_EQ(list.begin(), list.end());
+    for (const auto& [snapshot, frozen] : snapshots) {
+        ASSERT_THAT(snapshot, ::testing::ElementsAreArray(frozen));
+        ASSERT_THAT(std::vector<int>(snapshot.rbegin(), snapshot.rend()),
+                    ::testing::ElementsAreArray(frozen.rbegin(), frozen.rend()));
+    }
+}
+
+TEST(PersistentList, unsharedListChangesInPlace) {
+    persistent_unrolled_list<CountedCopy, 8> list;
+    for (int i = 0; i < 80; ++i) {
+        list.emplace_back(i);
+    }
+    {
+        auto snapshot = list.snapshot();
+    }
+    CountedCopy::CopiesCount = 0;
+
+    list.erase(std::next(list.begin(), 20));
+    list.insert(std::next(list.begin(), 20), CountedCopy(20));
+    list.edit(list.begin()).Value = 5;
+    ASSERT_EQ(CountedCopy::CopiesCount, 0);
+    ASSERT_EQ(std::ranges::distance(list.segments()), 10);
+}
+
+TEST(PersistentList, segmentsAndReverse) {
+    persistent_unrolled_list<int, 4> list{1, 2, 3, 4, 5, 6, 7, 8, 9};
+    std::vector<size_t> sizes;
+    for (auto segment : list.snapshot().segments()) {
+        sizes.push_back(segment.size());
+    }
+    ASSERT_THAT(sizes, ::testing::ElementsAre(4, 4, 1));
+    ASSERT_THAT(std::vector<int>(list.rbegin(), list.rend()), ::testing::ElementsAre(9, 8, 7, 6, 5, 4, 3, 2, 1));
+
+    list.clear();
+    ASSERT_TRUE(list.empty());
+    ASSERT_EQ(list.begin(), list.end());
+}
+
+/*
+    Если копирование ноды бросает исключение, список не меняется
+*/
+TEST(PersistentList, throwingCloneKeepsList) {
+    persistent_unrolled_list<CountedCopy, 8> list;
+    for (int i = 0; i < 20; ++i) {
+        list.emplace_back(i);
+    }
+    const auto snapshot = list.snapshot();
+
+    CountedCopy::CopiesLeft = 3;
+    ASSERT_THROW(list.erase(std::next(list.begin(), 10)), std::runtime_error);
+    CountedCopy::CopiesLeft = 1 << 30;
+    ASSERT_EQ(list.size(), 20);
+    ASSERT_EQ(list.snapshot(), snapshot);
+    ASSERT_EQ(&list[10], &snapshot[10]);
+}
+
+TEST(PersistentList, readersKeepSnapshotsWhileWriterRuns) {
+    persistent_unrolled_list<int, 16> list;
+    for (int i = 0; i < 1000; ++i) {
+        list.push_back(i);
+    }
+
+    std::atomic<bool> done = false;
+    std::vector<std::thread> readers;
+    std::atomic<int> mismatches = 0;
+    for (int reader = 0; reader < 3; ++reader) {
+        readers.emplace_back([&, snapshot = list.snapshot()] {
+            while (!done.load()) {
+                long long sum = 0;
+                for (int value : snapshot) {
+                    sum += value;
+                }
+                mismatches += sum != 999 * 1000 / 2;
+            }
+        });
+    }
+
+    std::mt19937 gen(5);
+    for (int step = 0; step < 20000; ++step) {
+        const size_t position = gen() % list.size();
+        list.edit(std::next(list.begin(), position)) += 1;
+        if (step % 2 == 0) {
+            list.insert(std::next(list.begin(), position), 0);
+        } else {
+            list.erase(std::next(list.begin(), position));
+        }
+    }
+    done = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    ASSERT_EQ(mismatches.load(), 0);
+    ASSERT_EQ(list.size(), 1000);
+}
@@ -0,0 +1,127 @@
+#include <unrolled_list.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <forward_list>
+#include <list>
+#include <ranges>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST(RangeMembers, fromRange) {
+    const std::vector<int> source{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+
+    unrolled_list<int, 4> from_vector(ul_from_range, source);
+    ASSERT_THAT(from_vector, ::testing::ElementsAreArray(source));
+    ASSERT_EQ(from_vector.size(), source.size());
+    ASSERT_EQ(std::ranges::distance(from_vector.segments()), 3);
+
+    unrolled_list<std::string, 4> from_view(ul_from_range,
+        source | std::views::transform([](int value) { return std::to_string(value * 10); }));
+    ASSERT_EQ(from_view.size(), 11);
+    ASSERT_EQ(from_view.front(), "10");
+    ASSERT_EQ(from_view.back(), "110");
+
+    // не sized_range: длина заранее неизвестна
+    unrolled_list<int, 4> from_filter(ul_from_range, source | std::views::filter([](int value) { return value % 2; }));
+    ASSERT_THAT(from_filter, ::testing::ElementsAre(1, 3, 5, 7, 9, 11));
+
+    std::istringstream stream("5 6 7 8 9");
+    unrolled_list<int, 2> from_input(ul_from_range, std::views::istream<int>(stream));
+    ASSERT_THAT(from_input, ::testing::ElementsAre(5, 6, 7, 8, 9));
+
+#if defined(__cpp_lib_containers_ranges)
+    unrolled_list<int, 4> from_std_tag(std::from_range, source);
+    ASSERT_EQ(from_std_tag, from_vector);
+#endif
+}
+
+TEST(RangeMembers, appendPrependInsert) {
+    unrolled_list<std::string, 3> unrolled_list{"a", "b"};
+    std::list<std::string> expected{"a", "b"};
+    const std::vector<std::string> batch{"1", "2", "3", "4", "5"};
+
+    unrolled_list.append_range(batch);
+    expected.insert(expected.end(), batch.begin(), batch.end());
+    ASSERT_THAT(unrolled_list, ::testing::ElementsAreArray(expected));
+
+    unrolled_list.prepend_range(batch | std::views::reverse);
+    expected.insert(expected.begin(), batch.rbegin(), batch.rend());
+    ASSERT_THAT(unrolled_list, ::testing::ElementsAreArray(expected));
+
+    auto it = unrolled_list.insert_range(unrolled_list.begin() + 4, std::forward_list<std::string>{"x", "y"});
+    expected.insert(std::next(expected.begin(), 4), {"x", "y"});
+    ASSERT_EQ(*it, "x");
+    ASSERT_THAT(unrolled_list, ::testing::ElementsAreArray(expected));
+
+    it = unrolled_list.insert_range(unrolled_list.begin() + 7, batch | std::views::take_while([](auto& s) { return s != "4"; }));
+    expected.insert(std::next(expected.begin(), 7), {"1", "2", "3"});
+    ASSERT_EQ(*it, "1");
+    ASSERT_THAT(unrolled_list, ::testing::ElementsAreArray(expected));
+
+    it = unrolled_list.insert_range(unrolled_list.end(), std::vector<std::string>{});
+    ASSERT_EQ(it, unrolled_list.end());
+    ASSERT_EQ(unrolled_list.size(), expected.size());
+}
+
+TEST(RangeMembers, assignRange) {
+    unrolled_list<int, 4, std::allocator<int>, ul_order_statistics_index> unrolled_list(ul_from_range, std::views::iota(0, 10));
+
+    unrolled_list.assign_range(std::views::iota(100, 125));
+    ASSERT_EQ(unrolled_list.size(), 25);
+    for (size_t i = 0; i < unrolled_list.size(); ++i) {
+        ASSERT_EQ(unrolled_list[i], 100 + static_cast<int>(i));
+    }
+
+    unrolled_list.assign_range(std::vector<int>{7, 8});
+    ASSERT_THAT(unrolled_list, ::testing::ElementsAre(7, 8));
+
+    std::istringstream stream("1 2 3 4 5 6");
+    unrolled_list.assign_range(std::views::istream<int>(stream));
+    ASSERT_THAT(unrolled_list, ::testing::ElementsAre(1, 2, 3, 4, 5, 6));
+    ASSERT_EQ(unrolled_list[5], 6);
+}
+
+namespace {
+
+struct ThrowingCopy {
+    static inline int CopiesLeft = 0;
+
+    explicit ThrowingCopy(int value) : Value(value) {}
+
+    ThrowingCopy(const ThrowingCopy& other) : Value(other.Value) {
+        if (CopiesLeft-- == 0) {
+            throw std::runtime_error("copy");
+        }
+    }
+
+    ThrowingCopy& operator=(const ThrowingCopy&) = default;
+
+    int Value;
+};
+
+}
+
+/*
+    Если копирование элемента бросает исключение, append_range не меняет список
+*/
+TEST(RangeMembers, appendRangeIsStrong) {
+    ThrowingCopy::CopiesLeft = 1000;
+    std::vector<ThrowingCopy> batch;
+    for (int i = 0; i < 20; ++i) {
+        batch.emplace_back(100 + i);
+    }
+    for (int fail_at = 0; fail_at < 20; fail_at += 3) {
+        ThrowingCopy::CopiesLeft = 1000;
+        unrolled_list<ThrowingCopy, 4> unrolled_list(ul_from_range, batch | std::views::take(6));
+
+        ThrowingCopy::CopiesLeft = fail_at;
+        ASSERT_THROW(unrolled_list.append_range(batch), std::runtime_error);
+        ASSERT_EQ(unrolled_list.size(), 6);
+        ASSERT_EQ(unrolled_list.back().Value, 105);
+        ASSERT_EQ(std::ranges::distance(unrolled_list.segments()), 2);
+    }
+}
@@ -0,0 +1,90 @@
+#include <unrolled_list.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <numeric>
+#include <string>
+#include <vector>
+
+/*
+    segments() отдаёт каждую ноду как непрерывный std::span:
+    конкатенация всех span'ов равна самому списку
+*/
+TEST(Segments, spansCoverList) {
+    unrolled_list<int, 4> list;
+    for (int i = 0; i < 10; ++i) {
+        list.push_back(i);
+        list.push_front(-i);
+    }
+
+    std::vector<int> joined;
+    size_t segments_count = 0;
+    for (std::span<int> segment : list.segments()) {
+        ASSERT_FALSE(segment.empty());
+        ASSERT_LE(segment.size(), 4);
+        joined.insert(joined.end(), segment.begin(), segment.end());
+        ++segments_count;
+    }
+    ASSERT_THAT(joined, ::testing::ElementsAreArray(list));
+    ASSERT_GE(segments_count, 5);
+
+    for (std::span<int> segment : list.segments()) {
+        segment[0] = 100;
+    }
+    ASSERT_EQ(list.front(), 100);
+
+    const auto& const_list = list;
+    auto segments = const_list.segments();
+    ASSERT_EQ(std::ranges::distance(segments), segments_count);
+    ASSERT_EQ((*std::ranges::prev(segments.end())).back(), 9);
+
+    unrolled_list<int, 4> empty;
+    ASSERT_TRUE(empty.segments().empty());
+}
+
+/*
+    ul_* алгоритмы на подотрезках, начинающихся и заканчивающихся посреди ноды,
+    совпадают с std-версиями
+*/
+TEST(Segments, algorithmsMatchStd) {
+    unrolled_list<int, 5> list;
+    std::vector<int> reference;
+    for (int i = 0; i < 53; ++i) {
+        list.push_back(i % 7);
+        reference.push_back(i % 7);
+    }
+
+    for (size_t first = 0; first < reference.size(); first += 6) {
+        for (size_t last = first; last <= reference.size(); last += 4) {
+            auto list_first = std::next(list.cbegin(), first);
+            auto list_last = std::next(list.cbegin(), last);
+            auto reference_first = reference.cbegin() + first;
+            auto reference_last = reference.cbegin() + last;
+
+            ASSERT_EQ(ul_count(list_first, list_last, 3), std::count(reference_first, reference_last, 3));
+            ASSERT_EQ(ul_accumulate(list_first, list_last, 0), std::accumulate(reference_first, reference_last, 0));
+            ASSERT_EQ(std::distance(list.cbegin(), ul_find(list_first, list_last, 5)),
+                std::distance(reference.cbegin(), std::find(reference_first, reference_last, 5)));
+
+            std::vector<int> copied;
+            ul_copy(list_first, list_last, std::back_inserter(copied));
+            ASSERT_THAT(copied, ::testing::ElementsAreArray(reference_first, reference_last));
+
+            int sum = 0;
+            ul_for_each(list_first, list_last, [&sum](int value) { sum += value; });
+            ASSERT_EQ(sum, std::accumulate(reference_first, reference_last, 0));
+        }
+    }
+
+    ASSERT_EQ(ul_find(list.begin(), list.end(), 42), list.end());
+
+    ul_fill(std::next(list.begin(), 3), std::next(list.begin(), 17), -1);
+    std::fill(reference.begin() + 3, reference.begin() + 17, -1);
+    ul_transform(list.begin(), list.end(), list.begin(), [](int value) { return value * 2; });
+    std::transform(reference.begin(), reference.end(), reference.begin(), [](int value) { return value * 2; });
+    ASSERT_THAT(list, ::testing::ElementsAreArray(reference));
+
+    std::vector<std::string> strings{"a", "b", "c"};
+    ASSERT_EQ(ul_accumulate(strings.begin(), strings.end(), std::string()), "abc");
+}
@@ -3,8 +3,15 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <array>
+#include <deque>
+#include <random>
+#include <string>
+#include <cstdint>
 #include <vector>
 #include <list>
+#include <iterator>
+#include <sstream>
 
 /*
     В данном файле представлен ряд тестов, где используются (вместе, раздельно и по-очереди):
@@ -107,4 +114,301 @@ TEST(UnrolledLinkedList, popFrontBack) {
     }
 
     ASSERT_TRUE(unrolled_list.empty());
-}
\ No newline at end of file
+}
+
+TEST(UnrolledLinkedList, countAndCopyConstruct) {
+    std::list<int> std_list(23, 7);
+    unrolled_list<int, 5> unrolled_list(23, 7);
+    auto copy = unrolled_list;
+
+    ASSERT_THAT(unrolled_list, ::testing::ElementsAreArray(std_list));
+    ASSERT_THAT(copy, ::testing::ElementsAreArray(std_list));
+    ASSERT_EQ(copy.size(), 23);
+}
+
+TEST(UnrolledLinkedList, copyKeepsNodeFill) {
+    unrolled_list<std::string, 4> strings;
+    std::list<std::string> std_strings;
+    unrolled_list<int, 4> ints;
+    std::list<int> std_ints;
+    for (int i = 0; i < 30; ++i) {
+        strings.push_front(std::to_string(i));
+        std_strings.push_front(std::to_string(i));
+        ints.push_front(i);
+        std_ints.push_front(i);
+    }
+    strings.erase(strings.begin() + 5, strings.begin() + 9);
+    std_strings.erase(std::next(std_strings.begin(), 5), std::next(std_strings.begin(), 9));
+    ints.erase(ints.begin() + 5, ints.begin() + 9);
+    std_ints.erase(std::next(std_ints.begin(), 5), std::next(std_ints.begin(), 9));
+
+    auto strings_copy = strings;
+    auto ints_copy = ints;
+    ASSERT_THAT(strings_copy, ::testing::ElementsAreArray(std_strings));
+    ASSERT_THAT(ints_copy, ::testing::ElementsAreArray(std_ints));
+    ASSERT_TRUE(std::ranges::equal(strings.segments(), strings_copy.segments(), std::ranges::equal));
+    ASSERT_TRUE(std::ranges::equal(ints.segments(), ints_copy.segments(), std::ranges::equal));
+
+    for (int count : {0, 3, 26, 50}) {
+        unrolled_list<std::string, 4> assigned_strings;
+        unrolled_list<int, 4> assigned_ints;
+        for (int i = 0; i < count; ++i) {
+            assigned_strings.push_front("x");
+            assigned_ints.push_front(-i);
+        }
+        assigned_strings = strings;
+        assigned_ints = ints;
+        ASSERT_THAT(assigned_strings, ::testing::ElementsAreArray(std_strings));
+        ASSERT_THAT(assigned_ints, ::testing::ElementsAreArray(std_ints));
+        ASSERT_EQ(assigned_ints.size(), std_ints.size());
+
+        const unrolled_list<std::string, 4> empty;
+        assigned_strings = empty;
+        ASSERT_TRUE(assigned_strings.empty());
+    }
+}
+
+TEST(UnrolledLinkedList, assignAndResize) {
+    unrolled_list<std::string, 4> unrolled_list{"a", "b", "c"};
+    std::vector<std::string> expected{"a", "b", "c"};
+
+    const std::vector<std::string> longer{"1", "2", "3", "4", "5", "6", "7", "8", "9"};
+    unrolled_list.assign(longer.begin(), longer.end());
+    ASSERT_THAT(unrolled_list, ::testing::ElementsAreArray(longer));
+
+    unrolled_list.assign({"x", "y"});
+    ASSERT_THAT(unrolled_list, ::testing::ElementsAre("x", "y"));
+
+    unrolled_list.assign(7, "z");
+    expected.assign(7, "z");
+    ASSERT_THAT(unrolled_list, ::testing::ElementsAreArray(expected));
+
+    // значение может лежать в самом списке
+    unrolled_list.push_back("w");
+    unrolled_list.assign(2, unrolled_list.back());
+    ASSERT_THAT(unrolled_list, ::testing::ElementsAre("w", "w"));
+
+    unrolled_list.resize(11, "r");
+    expected.assign(2, "w");
+    expected.resize(11, "r");
+    ASSERT_THAT(unrolled_list, ::testing::ElementsAreArray(expected));
+
+    unrolled_list.resize(14);
+    expected.resize(14);
+    ASSERT_THAT(unrolled_list, ::testing::ElementsAreArray(expected));
+
+    unrolled_list.resize(5);
+    expected.resize(5);
+    ASSERT_THAT(unrolled_list, ::testing::ElementsAreArray(expected));
+    ASSERT_EQ(unrolled_list.size(), 5);
+
+    unrolled_list.resize(0);
+    ASSERT_TRUE(unrolled_list.empty());
+
+    ::unrolled_list<int, 8> counted(20);
+    ASSERT_EQ(counted.size(), 20);
+    ASSERT_EQ(std::ranges::distance(counted.segments()), 3);
+}
+
+/*
+    shrink_to_fit упаковывает элементы в полностью заполненные ноды
+*/
+TEST(UnrolledLinkedList, shrinkToFitPacksNodes) {
+    unrolled_list<int, 5, std::allocator<int>, ul_order_statistics_index> unrolled_list;
+    std::vector<int> expected;
+    for (int i = 0; i < 100; ++i) {
+        unrolled_list.push_back(i);
+        unrolled_list.insert(unrolled_list.begin() + unrolled_list.size() / 2, -i);
+    }
+    unrolled_list.remove_if([](int value) { return value % 3 == 0; });
+    for (int i = 0; i < 30; ++i) {
+        unrolled_list.erase(unrolled_list.begin() + (i * 7) % unrolled_list.size());
+    }
+    expected.assign(unrolled_list.begin(), unrolled_list.end());
+
+    unrolled_list.shrink_to_fit();
+    ASSERT_THAT(unrolled_list, ::testing::ElementsAreArray(expected));
+    const auto segments = unrolled_list.segments();
+    ASSERT_EQ(std::ranges::distance(segments), (expected.size() + 4) / 5);
+    for (auto segment : segments | std::views::take(std::ranges::distance(segments) - 1)) {
+        ASSERT_EQ(segment.size(), 5);
+    }
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(unrolled_list[i], expected[i]);
+    }
+    ASSERT_EQ(unrolled_list.cached_nodes(), 0);
+}
+
+TEST(UnrolledLinkedList, insertRangeAndCount) {
+    std::list<int> std_list;
+    unrolled_list<int, 4> unrolled_list;
+    for (int i = 0; i < 10; ++i) {
+        std_list.push_back(i);
+        unrolled_list.push_back(i);
+    }
+    std::vector<int> batch(57);
+    for (int i = 0; i < 57; ++i) {
+        batch[i] = 100 + i;
+    }
+
+    auto std_result = std_list.insert(std::next(std_list.begin(), 5), batch.begin(), batch.end());
+    auto unrolled_result = unrolled_list.insert(std::next(unrolled_list.begin(), 5), batch.begin(), batch.end());
+    ASSERT_EQ(*unrolled_result, *std_result);
+
+    std_list.insert(std::next(std_list.begin(), 2), 2, -1);
+    unrolled_list.insert(std::next(unrolled_list.begin(), 2), 2, -1);
+    std_list.insert(std_list.begin(), 9, -2);
+    unrolled_list.insert(unrolled_list.begin(), 9, -2);
+    std_list.insert(std_list.end(), batch.begin(), batch.begin() + 3);
+    unrolled_list.insert(unrolled_list.end(), batch.begin(), batch.begin() + 3);
+
+    ASSERT_EQ(unrolled_list.size(), std_list.size());
+    ASSERT_THAT(unrolled_list, ::testing::ElementsAreArray(std_list));
+}
+
+TEST(UnrolledLinkedList, insertFromInputIterators) {
+    std::istringstream first_stream("1 2 3 4 5 6 7 8 9");
+    std::istringstream second_stream("1 2 3 4 5 6 7 8 9");
+    std::list<int> std_list{-1, -2, -3};
+    unrolled_list<int, 4> unrolled_list{-1, -2, -3};
+
+    std_list.insert(std::next(std_list.begin()),
+                    std::istream_iterator<int>(first_stream), std::istream_iterator<int>());
+    unrolled_list.insert(std::next(unrolled_list.begin()),
+                         std::istream_iterator<int>(second_stream), std::istream_iterator<int>());
+
+    ASSERT_THAT(unrolled_list, ::testing::ElementsAreArray(std_list));
+}
+
+TEST(UnrolledLinkedList, eraseRange) {
+    std::list<int> std_list;
+    unrolled_list<int, 4> unrolled_list;
+    for (int i = 0; i < 100; ++i) {
+        std_list.push_back(i);
+        unrolled_list.push_back(i);
+    }
+
+    auto std_it = std_list.erase(std::next(std_list.begin(), 1), std::next(std_list.begin(), 3));
+    auto unrolled_it = unrolled_list.erase(std::next(unrolled_list.begin(), 1), std::next(unrolled_list.begin(), 3));
+    ASSERT_EQ(*unrolled_it, *std_it);
+
+    std_it = std_list.erase(std::next(std_list.begin(), 6), std::next(std_list.begin(), 61));
+    unrolled_it = unrolled_list.erase(std::next(unrolled_list.begin(), 6), std::next(unrolled_list.begin(), 61));
+    ASSERT_EQ(*unrolled_it, *std_it);
+    ASSERT_THAT(unrolled_list, ::testing::ElementsAreArray(std_list));
+
+    std_list.erase(std::next(std_list.begin(), 20), std_list.end());
+    unrolled_it = unrolled_list.erase(std::next(unrolled_list.begin(), 20), unrolled_list.end());
+    ASSERT_EQ(unrolled_it, unrolled_list.end());
+    ASSERT_THAT(unrolled_list, ::testing::ElementsAreArray(std_list));
+
+    unrolled_list.erase(unrolled_list.begin(), unrolled_list.end());
+    ASSERT_TRUE(unrolled_list.empty());
+    ASSERT_EQ(unrolled_list.size(), 0);
+}
+
+TEST(UnrolledLinkedList, autoNodeSize) {
+    static_assert(ul_auto_node_size<int, 2> > ul_auto_node_size<int, 1>);
+    static_assert(ul_auto_node_size<char> > ul_auto_node_size<int>);
+    static_assert(ul_node_size_for_bytes<std::array<char, 1000>, 64> == 1);
+    static_assert(ul_node_size_for_bytes<std::int64_t, 64> == 4);
+    static_assert(ul_node_size_for_bytes<std::int64_t, 128, ul_order_statistics_index> == 7);
+    static_assert(ul_node_size_for_bytes<std::int64_t, 64, ul_order_statistics_index> == 1);
+    static_assert(ul_auto_node_size<int, 2, ul_order_statistics_index> < ul_auto_node_size<int, 2>);
+
+    std::list<int> std_list;
+    unrolled_list<int, ul_auto_node_size<int>> unrolled_list;
+    for (int i = 0; i < 100; ++i) {
+        std_list.push_front(i);
+        unrolled_list.push_front(i);
+    }
+
+    ASSERT_THAT(unrolled_list, ::testing::ElementsAreArray(std_list));
+}
+
+template<typename List, typename MakeValue>
+void CheckDequeOperations(MakeValue make_value) {
+    using value_type = typename List::value_type;
+    std::deque<value_type> std_deque;
+    List unrolled_list;
+    std::mt19937 gen(11);
+
+    for (int step = 0; step < 5000; ++step) {
+        const value_type value = make_value(step);
+        switch (gen() % 8) {
+            case 0:
+                std_deque.push_front(value);
+                unrolled_list.push_front(value);
+                break;
+            case 1:
+                std_deque.push_back(value);
+                unrolled_list.push_back(value);
+                break;
+            case 2:
+                if (!std_deque.empty()) {
+                    std_deque.pop_front();
+                    unrolled_list.pop_front();
+                }
+                break;
+            case 3:
+                if (!std_deque.empty()) {
+                    std_deque.pop_back();
+                    unrolled_list.pop_back();
+                }
+                break;
+            case 4: {
+                const size_t position = gen() % (std_deque.size() + 1);
+                std_deque.insert(std_deque.begin() + position, value);
+                ASSERT_EQ(*unrolled_list.insert(std::next(unrolled_list.begin(), position), value), value);
+                break;
+            }
+            case 5: {
+                const size_t position = gen() % (std_deque.size() + 1);
+                const std::vector<value_type> batch(gen() % 9 + 1, value);
+                std_deque.insert(std_deque.begin() + position, batch.begin(), batch.end());
+                unrolled_list.insert(std::next(unrolled_list.begin(), position), batch.begin(), batch.end());
+                break;
+            }
+            case 6: {
+                const size_t from = gen() % (std_deque.size() + 1);
+                const size_t to = std::min(std_deque.size(), from + gen() % 8);
+                std_deque.erase(std_deque.begin() + from, std_deque.begin() + to);
+                unrolled_list.erase(std::next(unrolled_list.begin(), from), std::next(unrolled_list.begin(), to));
+                break;
+            }
+            default:
+                if (!std_deque.empty()) {
+                    const size_t position = gen() % std_deque.size();
+                    std_deque.erase(std_deque.begin() + position);
+                    unrolled_list.erase(std::next(unrolled_list.begin(), position));
+                }
+        }
+        ASSERT_EQ(unrolled_list.size(), std_deque.size());
+    }
+
+    ASSERT_THAT(unrolled_list, ::testing::ElementsAreArray(std_deque));
+}
+
+TEST(UnrolledLinkedList, dequeOperationsMatchStdDeque) {
+    CheckDequeOperations<unrolled_list<std::string, 6>>([](int step) { return std::to_string(step); });
+}
+
+/*
+    Для тривиально копируемых типов сдвиги внутри ноды делаются через memmove
+*/
+TEST(UnrolledLinkedList, trivialDequeOperationsMatchStdDeque) {
+    struct Pod {
+        int64_t key;
+        char payload[12];
+
+        bool operator==(const Pod& other) const {
+            return key == other.key;
+        }
+    };
+    using pod_list = unrolled_list<Pod, 7>;
+    static_assert(pod_list::bitwise_copyable);
+    static_assert(!unrolled_list<std::string, 7>::bitwise_copyable);
+
+    CheckDequeOperations<pod_list>([](int step) { return Pod{step, {}}; });
+    CheckDequeOperations<unrolled_list<int, 5>>([](int step) { return step; });
+}
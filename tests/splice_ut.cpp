@@ -0,0 +1,162 @@
+#include <unrolled_list.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <list>
+#include <random>
+#include <string>
+#include <vector>
+
+class MoveCounter {
+public:
+    static inline int MovesCount = 0;
+
+    explicit MoveCounter(int value) : Value(value) {}
+
+    MoveCounter(MoveCounter&& other) noexcept : Value(other.Value) {
+        ++MovesCount;
+    }
+
+    MoveCounter& operator=(MoveCounter&& other) noexcept {
+        ++MovesCount;
+        Value = other.Value;
+        return *this;
+    }
+
+    int Value;
+};
+
+/*
+    Склейка и разрезание по границам нод только перевешивают указатели:
+    ни один элемент не перемещается
+*/
+TEST(Splice, wholeNodesAreNotMoved) {
+    unrolled_list<MoveCounter, 4> first;
+    unrolled_list<MoveCounter, 4> second;
+    for (int i = 0; i < 16; ++i) {
+        first.emplace_back(i);
+        second.emplace_back(100 + i);
+    }
+    MoveCounter::MovesCount = 0;
+
+    first.concat(std::move(second));
+    ASSERT_EQ(first.size(), 32);
+    ASSERT_TRUE(second.empty());
+
+    unrolled_list<MoveCounter, 4> tail = first.split(first.begin() + 8);
+    ASSERT_EQ(first.size(), 8);
+    ASSERT_EQ(tail.size(), 24);
+    ASSERT_EQ(tail.front().Value, 8);
+    ASSERT_EQ(tail.back().Value, 115);
+
+    first.splice(first.begin(), tail, tail.begin() + 4, tail.begin() + 12);
+    ASSERT_EQ(first.size(), 16);
+    ASSERT_EQ(first.front().Value, 12);
+    ASSERT_EQ(tail.size(), 16);
+
+    ASSERT_EQ(MoveCounter::MovesCount, 0);
+}
+
+TEST(Splice, randomOperationsMatchStdList) {
+    std::list<std::string> std_lists[2];
+    unrolled_list<std::string, 5> unrolled_lists[2];
+    std::mt19937 gen(17);
+
+    auto position_in = [&gen](const std::list<std::string>& list) {
+        return list.empty() ? 0 : gen() % (list.size() + 1);
+    };
+
+    for (int step = 0; step < 3000; ++step) {
+        const size_t target = gen() % 2;
+        const size_t source = gen() % 2;
+        auto& std_target = std_lists[target];
+        auto& unrolled_target = unrolled_lists[target];
+        auto& std_source = std_lists[source];
+        auto& unrolled_source = unrolled_lists[source];
+
+        switch (gen() % 5) {
+            case 0:
+            case 1:
+                for (int i = 0; i < 7; ++i) {
+                    std_target.push_back(std::to_string(step * 10 + i));
+                    unrolled_target.push_back(std::to_string(step * 10 + i));
+                }
+                break;
+            case 2: {
+                if (target == source) {
+                    break;
+                }
+                const size_t position = position_in(std_target);
+                std_target.splice(std::next(std_target.begin(), position), std_source);
+                unrolled_target.splice(std::next(unrolled_target.begin(), position), unrolled_source);
+                break;
+            }
+            case 3: {
+                size_t from = position_in(std_source);
+                size_t to = position_in(std_source);
+                if (from > to) {
+                    std::swap(from, to);
+                }
+                size_t position = position_in(std_target);
+                if (target == source && position >= from && position < to) {
+                    position = to;
+                }
+                std_target.splice(std::next(std_target.begin(), position), std_source,
+                    std::next(std_source.begin(), from), std::next(std_source.begin(), to));
+                unrolled_target.splice(std::next(unrolled_target.begin(), position), unrolled_source,
+                    std::next(unrolled_source.begin(), from), std::next(unrolled_source.begin(), to));
+                break;
+            }
+            default: {
+                if (target == source) {
+                    break;
+                }
+                const size_t position = position_in(std_source);
+                std_target.splice(std_target.end(), std_source, std::next(std_source.begin(), position), std_source.end());
+                unrolled_target.concat(unrolled_source.split(std::next(unrolled_source.begin(), position)));
+            }
+        }
+
+        for (size_t i = 0; i < 2; ++i) {
+            ASSERT_EQ(unrolled_lists[i].size(), std_lists[i].size());
+        }
+    }
+
+    for (size_t i = 0; i < 2; ++i) {
+        ASSERT_THAT(unrolled_lists[i], ::testing::ElementsAreArray(std_lists[i]));
+        ASSERT_THAT(std::vector<std::string>(unrolled_lists[i].rbegin(), unrolled_lists[i].rend()),
+            ::testing::ElementsAreArray(std_lists[i].rbegin(), std_lists[i].rend()));
+    }
+}
+
+TEST(Splice, keepsIndexConsistent) {
+    using indexed_list = unrolled_list<int, 4, std::allocator<int>, ul_order_statistics_index>;
+    indexed_list first;
+    indexed_list second;
+    std::vector<int> first_reference;
+    std::vector<int> second_reference;
+    for (int i = 0; i < 50; ++i) {
+        first.push_back(i);
+        second.push_back(100 + i);
+        first_reference.push_back(i);
+        second_reference.push_back(100 + i);
+    }
+
+    first.splice(first.begin() + 21, second, second.begin() + 3, second.begin() + 30);
+    first_reference.insert(first_reference.begin() + 21, second_reference.begin() + 3, second_reference.begin() + 30);
+    second_reference.erase(second_reference.begin() + 3, second_reference.begin() + 30);
+
+    second.concat(first.split(first.begin() + 40));
+    second_reference.insert(second_reference.end(), first_reference.begin() + 40, first_reference.end());
+    first_reference.resize(40);
+
+    for (auto [list, reference] : {std::pair{&first, &first_reference}, std::pair{&second, &second_reference}}) {
+        ASSERT_EQ(list->size(), reference->size());
+        for (size_t i = 0; i < reference->size(); ++i) {
+            ASSERT_EQ((*list)[i], (*reference)[i]);
+            ASSERT_EQ(list->index_of(list->nth(i)), i);
+        }
+        ASSERT_EQ(*(list->end() - 1), reference->back());
+    }
+}
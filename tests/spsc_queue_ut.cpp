@@ -0,0 +1,125 @@
+#include <unrolled_spsc_queue.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+template<typename T>
+class CountingAllocator : public std::allocator<T> {
+public:
+    using value_type = T;
+
+    static inline int Allocations = 0;
+
+    CountingAllocator() = default;
+
+    template<typename U>
+    CountingAllocator(const CountingAllocator<U>&) {}
+
+    template<typename U>
+    struct rebind {
+        using other = CountingAllocator<U>;
+    };
+
+    T* allocate(size_t count) {
+        ++CountingAllocator<char>::Allocations;
+        return std::allocator<T>::allocate(count);
+    }
+};
+
+}
+
+TEST(SpscQueue, fifoOrder) {
+    unrolled_spsc_queue<std::string, 4> queue;
+    ASSERT_TRUE(queue.empty());
+
+    for (int i = 0; i < 50; ++i) {
+        queue.push(std::to_string(i));
+    }
+    std::string value;
+    for (int i = 0; i < 30; ++i) {
+        ASSERT_TRUE(queue.try_pop(value));
+        ASSERT_EQ(value, std::to_string(i));
+    }
+    queue.emplace(3, 'x');
+
+    std::vector<std::string> rest;
+    ASSERT_EQ(queue.consume_all([&rest](std::string&& element) { rest.push_back(std::move(element)); }), 21);
+    ASSERT_EQ(rest.front(), "30");
+    ASSERT_EQ(rest.back(), "xxx");
+    ASSERT_TRUE(queue.empty());
+    ASSERT_FALSE(queue.try_pop(value));
+}
+
+/*
+    Ноды, которые покинул потребитель, производитель забирает обратно:
+    в установившемся режиме аллокаций нет
+*/
+TEST(SpscQueue, nodesAreReused) {
+    CountingAllocator<char>::Allocations = 0;
+    unrolled_spsc_queue<int, 8, CountingAllocator<int>> queue;
+    int value = 0;
+    for (int i = 0; i < 20; ++i) {
+        queue.push(i);
+    }
+    const int warm_allocations = CountingAllocator<char>::Allocations;
+
+    for (int i = 20; i < 10000; ++i) {
+        queue.push(i);
+        ASSERT_TRUE(queue.try_pop(value));
+        ASSERT_EQ(value, i - 20);
+    }
+    ASSERT_LE(CountingAllocator<char>::Allocations - warm_allocations, 1);
+}
+
+TEST(SpscQueue, destroysRemainingElements) {
+    auto shared = std::make_shared<int>(1);
+    {
+        unrolled_spsc_queue<std::shared_ptr<int>, 3> queue;
+        for (int i = 0; i < 10; ++i) {
+            queue.push(shared);
+        }
+        std::shared_ptr<int> value;
+        for (int i = 0; i < 4; ++i) {
+            ASSERT_TRUE(queue.try_pop(value));
+        }
+        value.reset();
+        ASSERT_EQ(shared.use_count(), 7);
+    }
+    ASSERT_EQ(shared.use_count(), 1);
+}
+
+TEST(SpscQueue, producerAndConsumerThreads) {
+    constexpr int count = 1'000'000;
+    unrolled_spsc_queue<int, 32> queue;
+
+    std::thread producer([&queue] {
+        for (int i = 0; i < count; ++i) {
+            queue.push(i);
+        }
+    });
+
+    int expected = 0;
+    bool in_order = true;
+    while (expected < count) {
+        queue.consume_all([&](int value) {
+            in_order = in_order && value == expected;
+            ++expected;
+        });
+        int value;
+        if (expected < count && queue.try_pop(value)) {
+            in_order = in_order && value == expected;
+            ++expected;
+        }
+    }
+    producer.join();
+
+    ASSERT_TRUE(in_order);
+    ASSERT_TRUE(queue.empty());
+}